@@ -2,22 +2,35 @@
 #define LTEXTURE_HPP
 
 #include <iostream>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_image.h>
 using namespace std;
+// Owns one SDL_Texture. Move-only: a moved-from LTexture is empty, and
+// copying is not allowed because both copies would destroy the texture.
+// Loading replaces (and destroys) whatever was loaded before.
 class LTexture
 {
 public:
     LTexture();
     ~LTexture();
+    LTexture(const LTexture &) = delete;
+    LTexture &operator=(const LTexture &) = delete;
+    LTexture(LTexture &&other) noexcept;
+    LTexture &operator=(LTexture &&other) noexcept;
     bool loadFromFile(SDL_Renderer *renderer, std::string path);
+    bool loadFromSurface(SDL_Renderer *renderer, SDL_Surface *surface);
     bool loadFromRenderedText(SDL_Renderer *renderer, TTF_Font *font, std::string textureText, SDL_Color textColor);
     void free();
+    void setAlpha(Uint8 alpha);
     void render(SDL_Renderer *renderer, int x, int y, SDL_Rect *clip = NULL, double angle = 0.0, SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
-    int getWidth();
-    int getHeight();
+    SDL_Texture *getTexture() const noexcept;
+    int getWidth() const noexcept;
+    int getHeight() const noexcept;
 
 private:
     SDL_Texture *mTexture;
@@ -25,6 +38,10 @@ private:
     int mHeight;
 };
 
+// Shared handle for assets that several screens or frames use; the texture
+// is destroyed with its last handle.
+typedef shared_ptr<LTexture> SharedTexture;
+
 LTexture::LTexture()
 {
     mTexture = NULL;
@@ -37,32 +54,57 @@ LTexture::~LTexture()
     free();
 }
 
+LTexture::LTexture(LTexture &&other) noexcept
+{
+    mTexture = exchange(other.mTexture, nullptr);
+    mWidth = exchange(other.mWidth, 0);
+    mHeight = exchange(other.mHeight, 0);
+}
+
+LTexture &LTexture::operator=(LTexture &&other) noexcept
+{
+    if (this != &other)
+    {
+        free();
+        mTexture = exchange(other.mTexture, nullptr);
+        mWidth = exchange(other.mWidth, 0);
+        mHeight = exchange(other.mHeight, 0);
+    }
+    return *this;
+}
+
 bool LTexture::loadFromFile(SDL_Renderer *renderer, std::string path)
 {
     free();
-    SDL_Texture *newTexture = NULL;
     SDL_Surface *loadedSurface = IMG_Load(path.c_str());
     if (loadedSurface == NULL)
     {
         cout << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << endl;
+        return false;
     }
-    else
+    if (!loadFromSurface(renderer, loadedSurface))
     {
-        newTexture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
-        if (newTexture == NULL)
-        {
-            cout << "Unable to create texture from " << path << "! SDL Error: " << SDL_GetError() << endl;
-        }
-        else
-        {
-            mWidth = loadedSurface->w;
-            mHeight = loadedSurface->h;
-        }
-
-        SDL_FreeSurface(loadedSurface);
+        cout << "Unable to create texture from " << path << "! SDL Error: " << SDL_GetError() << endl;
     }
+    SDL_FreeSurface(loadedSurface);
+    return mTexture != NULL;
+}
 
-    mTexture = newTexture;
+// Uploads the surface and leaves it to the caller, so one decoded image can
+// back several textures or be uploaded again after a device reset.
+bool LTexture::loadFromSurface(SDL_Renderer *renderer, SDL_Surface *surface)
+{
+    free();
+    if (surface == NULL)
+    {
+        return false;
+    }
+    mTexture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (mTexture != NULL)
+    {
+        mWidth = surface->w;
+        mHeight = surface->h;
+    }
     return mTexture != NULL;
 }
 
@@ -72,16 +114,10 @@ bool LTexture::loadFromRenderedText(SDL_Renderer *renderer, TTF_Font *font, std:
     SDL_Surface *textSurface = TTF_RenderText_Solid(font, textureText.c_str(), textColor);
     if (textSurface != NULL)
     {
-        mTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-        if (mTexture == NULL)
+        if (!loadFromSurface(renderer, textSurface))
         {
             cout << "Unable to create texture from rendered text! SDL Error: " << SDL_GetError() << endl;
         }
-        else
-        {
-            mWidth = textSurface->w;
-            mHeight = textSurface->h;
-        }
 
         SDL_FreeSurface(textSurface);
     }
@@ -104,6 +140,15 @@ void LTexture::free()
     }
 }
 
+void LTexture::setAlpha(Uint8 alpha)
+{
+    if (mTexture != NULL)
+    {
+        SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureAlphaMod(mTexture, alpha);
+    }
+}
+
 void LTexture::render(SDL_Renderer *renderer, int x, int y, SDL_Rect *clip, double angle, SDL_Point *center, SDL_RendererFlip flip)
 {
     SDL_Rect renderQuad = {x, y, mWidth, mHeight};
@@ -116,13 +161,56 @@ void LTexture::render(SDL_Renderer *renderer, int x, int y, SDL_Rect *clip, doub
     SDL_RenderCopyEx(renderer, mTexture, clip, &renderQuad, angle, center, flip);
 }
 
-int LTexture::getWidth()
+SDL_Texture *LTexture::getTexture() const noexcept
+{
+    return mTexture;
+}
+
+int LTexture::getWidth() const noexcept
 {
     return mWidth;
 }
 
-int LTexture::getHeight()
+int LTexture::getHeight() const noexcept
 {
     return mHeight;
 }
+
+// Loads each image file once per renderer and hands out shared handles to
+// it. Textures are kept per renderer, so a second renderer gets its own
+// copy rather than one it cannot draw. A file that failed to load is
+// remembered too, so asking again every frame does not go back to the disk.
+// clear() must run before any of the renderers is destroyed; handles still
+// held elsewhere keep their textures until they are dropped.
+class TextureCache
+{
+public:
+    SharedTexture load(SDL_Renderer *renderer, const string &path);
+    void clear();
+
+private:
+    unordered_map<SDL_Renderer *, unordered_map<string, SharedTexture>> mTextures;
+};
+
+SharedTexture TextureCache::load(SDL_Renderer *renderer, const string &path)
+{
+    unordered_map<string, SharedTexture> &textures = mTextures[renderer];
+    auto found = textures.find(path);
+    if (found != textures.end())
+    {
+        return found->second;
+    }
+    SharedTexture texture = make_shared<LTexture>();
+    if (!texture->loadFromFile(renderer, path))
+    {
+        texture.reset();
+    }
+    textures[path] = texture;
+    return texture;
+}
+
+void TextureCache::clear()
+{
+    mTextures.clear();
+}
 #endif 
\ No newline at end of file
@@ -0,0 +1,416 @@
+#ifndef CIPHER_HPP
+#define CIPHER_HPP
+
+#include <string>
+#include <cstddef>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+// Letter-only byte kernels shared by the ciphers below. Case is preserved and
+// every byte that is not A-Z or a-z is copied through unchanged. The plain
+// versions are kept public so the benchmark can compare them with the
+// vectorized paths, which are picked at compile time (AVX2, then SSE2/SSSE3).
+void shiftLettersScalar(const char *in, char *out, size_t n, int shift)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        char c = in[i];
+        if (c >= 'a' && c <= 'z')
+        {
+            out[i] = (char)('a' + (c - 'a' + shift) % 26);
+        }
+        else if (c >= 'A' && c <= 'Z')
+        {
+            out[i] = (char)('A' + (c - 'A' + shift) % 26);
+        }
+        else
+        {
+            out[i] = c;
+        }
+    }
+}
+
+void reflectLettersScalar(const char *in, char *out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        char c = in[i];
+        if (c >= 'a' && c <= 'z')
+        {
+            out[i] = (char)('a' + 'z' - c);
+        }
+        else if (c >= 'A' && c <= 'Z')
+        {
+            out[i] = (char)('A' + 'Z' - c);
+        }
+        else
+        {
+            out[i] = c;
+        }
+    }
+}
+
+// table[i] is the alphabet index (0-25) that letter i is replaced with.
+void substituteLettersScalar(const char *in, char *out, size_t n, const unsigned char table[26])
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        char c = in[i];
+        if (c >= 'a' && c <= 'z')
+        {
+            out[i] = (char)('a' + table[c - 'a']);
+        }
+        else if (c >= 'A' && c <= 'Z')
+        {
+            out[i] = (char)('A' + table[c - 'A']);
+        }
+        else
+        {
+            out[i] = c;
+        }
+    }
+}
+
+#if defined(__AVX2__)
+// Returns the letter mask and writes each lane's case base ('a', 'A' or 0).
+inline __m256i letterBase256(__m256i v, __m256i &base)
+{
+    __m256i isLower = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), v));
+    __m256i isUpper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    base = _mm256_or_si256(_mm256_and_si256(isLower, _mm256_set1_epi8('a')), _mm256_and_si256(isUpper, _mm256_set1_epi8('A')));
+    return _mm256_or_si256(isLower, isUpper);
+}
+#endif
+
+#if defined(__SSE2__)
+inline __m128i letterBase128(__m128i v, __m128i &base)
+{
+    __m128i isLower = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('z' + 1)));
+    __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    base = _mm_or_si128(_mm_and_si128(isLower, _mm_set1_epi8('a')), _mm_and_si128(isUpper, _mm_set1_epi8('A')));
+    return _mm_or_si128(isLower, isUpper);
+}
+#endif
+
+void shiftLetters(const char *in, char *out, size_t n, int shift)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i base;
+        __m256i letter = letterBase256(v, base);
+        __m256i t = _mm256_add_epi8(_mm256_sub_epi8(v, base), _mm256_set1_epi8((char)shift));
+        __m256i wrap = _mm256_cmpgt_epi8(t, _mm256_set1_epi8(25));
+        t = _mm256_add_epi8(_mm256_sub_epi8(t, _mm256_and_si256(wrap, _mm256_set1_epi8(26))), base);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_blendv_epi8(v, t, letter));
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i base;
+        __m128i letter = letterBase128(v, base);
+        __m128i t = _mm_add_epi8(_mm_sub_epi8(v, base), _mm_set1_epi8((char)shift));
+        __m128i wrap = _mm_cmpgt_epi8(t, _mm_set1_epi8(25));
+        t = _mm_add_epi8(_mm_sub_epi8(t, _mm_and_si128(wrap, _mm_set1_epi8(26))), base);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_or_si128(_mm_and_si128(letter, t), _mm_andnot_si128(letter, v)));
+    }
+#endif
+    shiftLettersScalar(in + i, out + i, n - i, shift);
+}
+
+void reflectLetters(const char *in, char *out, size_t n)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i base;
+        __m256i letter = letterBase256(v, base);
+        // base + 25 - (v - base), i.e. 'a' + 'z' - v for lower case.
+        __m256i t = _mm256_sub_epi8(_mm256_add_epi8(_mm256_add_epi8(base, base), _mm256_set1_epi8(25)), v);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_blendv_epi8(v, t, letter));
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i base;
+        __m128i letter = letterBase128(v, base);
+        __m128i t = _mm_sub_epi8(_mm_add_epi8(_mm_add_epi8(base, base), _mm_set1_epi8(25)), v);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_or_si128(_mm_and_si128(letter, t), _mm_andnot_si128(letter, v)));
+    }
+#endif
+    reflectLettersScalar(in + i, out + i, n - i);
+}
+
+// A 26-entry lookup needs a byte shuffle, so plain SSE2 builds use the scalar
+// table; SSSE3 and AVX2 do two 16-entry shuffles and pick one per lane.
+void substituteLetters(const char *in, char *out, size_t n, const unsigned char table[26])
+{
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSSE3__)
+    unsigned char low[16], high[16];
+    for (int k = 0; k < 16; ++k)
+    {
+        low[k] = table[k];
+        high[k] = (k < 10) ? table[16 + k] : 0;
+    }
+    __m128i low128 = _mm_loadu_si128((const __m128i *)low);
+    __m128i high128 = _mm_loadu_si128((const __m128i *)high);
+#endif
+#if defined(__AVX2__)
+    __m256i low256 = _mm256_broadcastsi128_si256(low128);
+    __m256i high256 = _mm256_broadcastsi128_si256(high128);
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i base;
+        __m256i letter = letterBase256(v, base);
+        __m256i index = _mm256_and_si256(_mm256_sub_epi8(v, base), letter);
+        __m256i inHigh = _mm256_cmpgt_epi8(index, _mm256_set1_epi8(15));
+        __m256i fromLow = _mm256_shuffle_epi8(low256, index);
+        __m256i fromHigh = _mm256_shuffle_epi8(high256, _mm256_sub_epi8(index, _mm256_set1_epi8(16)));
+        __m256i t = _mm256_add_epi8(_mm256_blendv_epi8(fromLow, fromHigh, inHigh), base);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_blendv_epi8(v, t, letter));
+    }
+#endif
+#if defined(__SSSE3__)
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i base;
+        __m128i letter = letterBase128(v, base);
+        __m128i index = _mm_and_si128(_mm_sub_epi8(v, base), letter);
+        __m128i inHigh = _mm_cmpgt_epi8(index, _mm_set1_epi8(15));
+        __m128i fromLow = _mm_shuffle_epi8(low128, index);
+        __m128i fromHigh = _mm_shuffle_epi8(high128, _mm_sub_epi8(index, _mm_set1_epi8(16)));
+        __m128i t = _mm_add_epi8(_mm_or_si128(_mm_and_si128(inHigh, fromHigh), _mm_andnot_si128(inHigh, fromLow)), base);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_or_si128(_mm_and_si128(letter, t), _mm_andnot_si128(letter, v)));
+    }
+#endif
+    substituteLettersScalar(in + i, out + i, n - i, table);
+}
+
+// Common interface for every cipher the puzzles can use. encodeBytes and
+// decodeBytes work on raw buffers so batches can be transformed in place
+// without building strings; encode/decode are the convenient string forms.
+class Cipher
+{
+public:
+    virtual ~Cipher() {}
+    virtual string name() const = 0;
+    virtual void encodeBytes(const char *in, char *out, size_t n) const = 0;
+    virtual void decodeBytes(const char *in, char *out, size_t n) const = 0;
+
+    string encode(const string &plainText) const
+    {
+        string cipherText(plainText.length(), '\0');
+        encodeBytes(plainText.data(), &cipherText[0], plainText.length());
+        return cipherText;
+    }
+
+    string decode(const string &cipherText) const
+    {
+        string plainText(cipherText.length(), '\0');
+        decodeBytes(cipherText.data(), &plainText[0], cipherText.length());
+        return plainText;
+    }
+};
+
+class CaesarCipher : public Cipher
+{
+public:
+    CaesarCipher(int shift) : shift(((shift % 26) + 26) % 26) {}
+
+    string name() const
+    {
+        return "Caesar " + to_string(shift);
+    }
+
+    void encodeBytes(const char *in, char *out, size_t n) const
+    {
+        shiftLetters(in, out, n, shift);
+    }
+
+    void decodeBytes(const char *in, char *out, size_t n) const
+    {
+        shiftLetters(in, out, n, (26 - shift) % 26);
+    }
+
+    int getShift() const
+    {
+        return shift;
+    }
+
+private:
+    int shift;
+};
+
+class RotCipher : public CaesarCipher
+{
+public:
+    RotCipher(int n = 13) : CaesarCipher(n) {}
+
+    string name() const
+    {
+        return "ROT-" + to_string(getShift());
+    }
+};
+
+class AtbashCipher : public Cipher
+{
+public:
+    string name() const
+    {
+        return "Atbash";
+    }
+
+    void encodeBytes(const char *in, char *out, size_t n) const
+    {
+        reflectLetters(in, out, n);
+    }
+
+    void decodeBytes(const char *in, char *out, size_t n) const
+    {
+        reflectLetters(in, out, n);
+    }
+};
+
+// Keyed monoalphabetic substitution: the cipher alphabet is the keyword with
+// repeated letters dropped, followed by the rest of the alphabet in order.
+class SubstitutionCipher : public Cipher
+{
+public:
+    SubstitutionCipher(const string &keyword) : keyword(keyword)
+    {
+        bool used[26] = {false};
+        int next = 0;
+        for (char c : keyword)
+        {
+            int letter = (c >= 'a' && c <= 'z') ? c - 'a' : (c >= 'A' && c <= 'Z') ? c - 'A' : -1;
+            if (letter >= 0 && !used[letter])
+            {
+                used[letter] = true;
+                forward[next++] = (unsigned char)letter;
+            }
+        }
+        for (int letter = 0; letter < 26; ++letter)
+        {
+            if (!used[letter])
+            {
+                forward[next++] = (unsigned char)letter;
+            }
+        }
+        for (int i = 0; i < 26; ++i)
+        {
+            inverse[forward[i]] = (unsigned char)i;
+        }
+    }
+
+    string name() const
+    {
+        return "Substitution " + keyword;
+    }
+
+    void encodeBytes(const char *in, char *out, size_t n) const
+    {
+        substituteLetters(in, out, n, forward);
+    }
+
+    void decodeBytes(const char *in, char *out, size_t n) const
+    {
+        substituteLetters(in, out, n, inverse);
+    }
+
+private:
+    string keyword;
+    unsigned char forward[26];
+    unsigned char inverse[26];
+};
+
+// Classic Vigenere: the key only advances on letters, so the shift of a byte
+// depends on how many letters came before it. That serial dependency keeps
+// this one on the scalar path.
+class VigenereCipher : public Cipher
+{
+public:
+    VigenereCipher(const string &key)
+    {
+        for (char c : key)
+        {
+            if (c >= 'a' && c <= 'z')
+            {
+                shifts.push_back((char)(c - 'a'));
+            }
+            else if (c >= 'A' && c <= 'Z')
+            {
+                shifts.push_back((char)(c - 'A'));
+            }
+        }
+        if (shifts.empty())
+        {
+            shifts.push_back(0);
+        }
+    }
+
+    string name() const
+    {
+        string key;
+        for (char s : shifts)
+        {
+            key += (char)('A' + s);
+        }
+        return "Vigenere " + key;
+    }
+
+    void encodeBytes(const char *in, char *out, size_t n) const
+    {
+        apply(in, out, n, false);
+    }
+
+    void decodeBytes(const char *in, char *out, size_t n) const
+    {
+        apply(in, out, n, true);
+    }
+
+private:
+    string shifts;
+
+    void apply(const char *in, char *out, size_t n, bool inverse) const
+    {
+        size_t k = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            char c = in[i];
+            int shift = shifts[k % shifts.length()];
+            if (inverse)
+            {
+                shift = (26 - shift) % 26;
+            }
+            if (c >= 'a' && c <= 'z')
+            {
+                out[i] = (char)('a' + (c - 'a' + shift) % 26);
+                ++k;
+            }
+            else if (c >= 'A' && c <= 'Z')
+            {
+                out[i] = (char)('A' + (c - 'A' + shift) % 26);
+                ++k;
+            }
+            else
+            {
+                out[i] = c;
+            }
+        }
+    }
+};
+
+#endif
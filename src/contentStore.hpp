@@ -0,0 +1,148 @@
+#ifndef CONTENTSTORE_HPP
+#define CONTENTSTORE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "mappedFile.hpp"
+using namespace std;
+
+// Puzzle text (riddles, potion scenarios and codes) converted by
+// tools/contentConverter from the text files in textFiles/. Every entry has
+// the same number of fields, stored back to back in one text blob. Binary
+// layout (little-endian):
+//   ContentStoreHeader
+//   uint32_t offsets[entryCount * fieldCount + 1]  at indexOffset
+//   text blob of textSize bytes                    at textOffset
+// Field f of entry e spans offsets[e * fieldCount + f] up to the next offset.
+// open() checks the header and that the offsets never run backwards or past
+// the blob; entries are then string_views straight into the mapping.
+struct ContentStoreHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t fieldCount;
+    uint32_t indexOffset;
+    uint32_t textOffset;
+    uint32_t textSize;
+};
+
+const char CONTENT_STORE_MAGIC[4] = {'E', 'R', 'C', 'S'};
+const uint32_t CONTENT_STORE_VERSION = 1;
+
+class ContentStore
+{
+public:
+    ContentStore();
+    bool open(const string &path, uint32_t fieldCount);
+    size_t size() const;
+    uint32_t getFieldCount() const;
+    string_view field(size_t entry, uint32_t f = 0) const;
+    size_t fieldOffset(size_t entry, uint32_t f = 0) const;
+    string_view text() const;
+
+private:
+    MappedFile mFile;
+    const uint32_t *mOffsets;
+    const char *mText;
+    size_t mCount;
+    uint32_t mFields;
+    uint32_t mTextSize;
+};
+
+ContentStore::ContentStore()
+{
+    mOffsets = NULL;
+    mText = NULL;
+    mCount = 0;
+    mFields = 0;
+    mTextSize = 0;
+}
+
+bool ContentStore::open(const string &path, uint32_t fieldCount)
+{
+    mOffsets = NULL;
+    mText = NULL;
+    mCount = 0;
+    mFields = 0;
+    mTextSize = 0;
+    if (!mFile.open(path))
+    {
+        return false;
+    }
+
+    ContentStoreHeader header;
+    if (mFile.size() < sizeof(header))
+    {
+        cout << "Content store " << path << " is truncated!" << endl;
+        return false;
+    }
+    memcpy(&header, mFile.data(), sizeof(header));
+    if (memcmp(header.magic, CONTENT_STORE_MAGIC, 4) != 0 || header.version != CONTENT_STORE_VERSION)
+    {
+        cout << "Content store " << path << " has an unknown format!" << endl;
+        return false;
+    }
+    if (header.fieldCount != fieldCount)
+    {
+        cout << "Content store " << path << " has " << header.fieldCount << " fields per entry, expected " << fieldCount << endl;
+        return false;
+    }
+
+    uint64_t offsetCount = (uint64_t)header.entryCount * header.fieldCount + 1;
+    if (header.indexOffset % alignof(uint32_t) != 0 || header.indexOffset + offsetCount * sizeof(uint32_t) > mFile.size() ||
+        (uint64_t)header.textOffset + header.textSize > mFile.size())
+    {
+        cout << "Content store " << path << " is corrupt!" << endl;
+        return false;
+    }
+    const uint32_t *offsets = (const uint32_t *)(mFile.data() + header.indexOffset);
+    for (uint64_t i = 0; i < offsetCount; ++i)
+    {
+        if ((i > 0 && offsets[i] < offsets[i - 1]) || offsets[i] > header.textSize)
+        {
+            cout << "Content store " << path << " is corrupt!" << endl;
+            return false;
+        }
+    }
+
+    mOffsets = offsets;
+    mText = mFile.data() + header.textOffset;
+    mCount = header.entryCount;
+    mFields = header.fieldCount;
+    mTextSize = header.textSize;
+    return true;
+}
+
+size_t ContentStore::size() const
+{
+    return mCount;
+}
+
+uint32_t ContentStore::getFieldCount() const
+{
+    return mFields;
+}
+
+string_view ContentStore::field(size_t entry, uint32_t f) const
+{
+    size_t i = entry * mFields + f;
+    return string_view(mText + mOffsets[i], mOffsets[i + 1] - mOffsets[i]);
+}
+
+// Position of a field inside text(), for code that lays out or draws runs of
+// the whole blob.
+size_t ContentStore::fieldOffset(size_t entry, uint32_t f) const
+{
+    return mOffsets[entry * mFields + f];
+}
+
+string_view ContentStore::text() const
+{
+    return string_view(mText, mTextSize);
+}
+
+#endif
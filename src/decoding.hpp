@@ -5,11 +5,23 @@
 #include <chrono>
 #include <ctime>
 #include <vector>
-#include <thread>
 #include <cmath>
 #include "DSA.hpp"
+#include "cipher.hpp"
+#include "puzzlePack.hpp"
+#include "glyphCache.hpp"
+#include "textAnimation.hpp"
+#include "widgets.hpp"
+#include "spriteBatch.hpp"
+#include "textureAtlas.hpp"
+#include "LTexture.hpp"
 
 using namespace std;
+// The instruction screen (images/cipherbg3.png) tells the player to shift
+// every letter by this much, and the key is never shown, so it is the only
+// key a puzzle may use.
+const int DECODING_SHIFT = 3;
+
 struct KeyButton
 {
     SDL_Rect rect;
@@ -22,7 +34,13 @@ public:
     ~Decoding();
     SDL_Window *dWindow;
     SDL_Renderer *dRenderer;
-    TTF_Font *gFont;
+    bool ttfStarted;
+    GlyphCache glyphs;
+    SpriteBatch batch;
+    TextureAtlas uiAtlas;
+    TextureCache textures;
+    int closeSprite;
+    TextAnimation cipherReveal, passwordReveal;
     SDL_Point mousePos;
     int mouseX, mouseY;
     const int SCWidth = 900;
@@ -32,7 +50,11 @@ public:
     SDL_Rect startButtonRect, instructButtonRect, backButtonRect, enterButtonRect;
     int DEFAULT_FONT_SIZE = 28;
     vector<KeyButton> keyboardButtons;
+    SDL_Texture *keyboardLayer;
+    SDL_Rect keyboardBounds;
+    WidgetRegistry menuWidgets, instructionWidgets, cipherWidgets;
     string wordArray[4];
+    PuzzlePack puzzles;
     enum GameState
     {
         MAIN_MENU,
@@ -41,24 +63,40 @@ public:
         STACK_SCREEN,
         YOU_LOST
     };
+    // Keyboard keys use their index in keyboardButtons as widget id.
+    enum WidgetId
+    {
+        START_WIDGET = 1000,
+        INSTRUCT_WIDGET,
+        BACK_WIDGET,
+        ENTER_WIDGET
+    };
 
     bool init();
     bool loadMedia();
     void close();
     void initializeButtons(vector<KeyButton> &keyboardButtons);
+    void initializeWidgets();
+    WidgetRegistry *widgetsFor(GameState state);
     void renderText(const string &text, int x, int y, SDL_Color textColor);
     void renderVirtualKeyboard(const vector<KeyButton> &keyboardButtons);
+    void queueKeys(const vector<KeyButton> &keyboardButtons, int offsetX, int offsetY, SDL_Color fillColor);
+    void drawKeyLabels(const vector<KeyButton> &keyboardButtons, int offsetX, int offsetY);
+    bool buildKeyboardLayer(const vector<KeyButton> &keyboardButtons);
+    void destroyKeyboardLayer();
     bool renderPopup(const string &message, int popupWidth, int popupHeight);
     bool successfulDecoding();
     string toLowerCase(const string &str);
     string encodeCaesarCipher(const string &plainText, int shift);
     string reverseWithStack(const string &message);
+    void pickPuzzle(string &originalText, string &cipheredText);
     string run();
 };
 
 Decoding::Decoding()
-    : dWindow(nullptr), dRenderer(nullptr), gFont(nullptr), SCWidth(900), SCHeight(700), TEXT_TYPING_SPEED(100), DEFAULT_FONT_SIZE(28),
-      displayPopup(false), textDecoded(false),startButtonRect({217, 55, 240, 260}), instructButtonRect({522, 120, 80, 110}), backButtonRect({10, SCHeight - 60, 100, 50}), enterButtonRect({SCWidth - 140, SCHeight - 110, 120, 50})
+    : dWindow(nullptr), dRenderer(nullptr), ttfStarted(false), closeSprite(-1), SCWidth(900), SCHeight(700), TEXT_TYPING_SPEED(100),
+      displayPopup(false), textDecoded(false),startButtonRect({217, 55, 240, 260}), instructButtonRect({522, 120, 80, 110}), backButtonRect({10, SCHeight - 60, 100, 50}), enterButtonRect({SCWidth - 140, SCHeight - 110, 120, 50}),
+      DEFAULT_FONT_SIZE(28), keyboardLayer(nullptr), menuWidgets(SCWidth, SCHeight), instructionWidgets(SCWidth, SCHeight), cipherWidgets(SCWidth, SCHeight)
 
 {
     if (!init() || !loadMedia())
@@ -66,10 +104,12 @@ Decoding::Decoding()
         cout << "Failed to initialize, load media, or load images\n";
     }
     initializeButtons(keyboardButtons);
+    initializeWidgets();
     wordArray[0] = "queue";
     wordArray[1] = "algorithm";
     wordArray[2] = "stack";
     wordArray[3] = "binary tree";
+    puzzles.open("textFiles/decoding_puzzles.bin");
 }
 void Decoding::initializeButtons(vector<KeyButton> &keyboardButtons)
 {
@@ -94,10 +134,10 @@ void Decoding::initializeButtons(vector<KeyButton> &keyboardButtons)
     for (int i = 0; i < rows; ++i)
     {
         const string &rowText = rowTexts[i];
-        for (int j = 0; j < rowText.length(); ++j)
+        for (size_t j = 0; j < rowText.length(); ++j)
         {
             KeyButton button;
-            button.rect = {startX + j * (buttonWidth + buttonPaddingX), startY + i * (buttonHeight + buttonPaddingY), buttonWidth, buttonHeight};
+            button.rect = {startX + (int)j * (buttonWidth + buttonPaddingX), startY + i * (buttonHeight + buttonPaddingY), buttonWidth, buttonHeight};
             button.text = rowText[j];
             keyboardButtons.push_back(button);
         }
@@ -114,6 +154,34 @@ void Decoding::initializeButtons(vector<KeyButton> &keyboardButtons)
     keyboardButtons.push_back(backspaceButton);
 }
 
+void Decoding::initializeWidgets()
+{
+    menuWidgets.add(START_WIDGET, startButtonRect);
+    menuWidgets.add(INSTRUCT_WIDGET, instructButtonRect);
+    instructionWidgets.add(BACK_WIDGET, backButtonRect);
+    for (size_t i = 0; i < keyboardButtons.size(); ++i)
+    {
+        cipherWidgets.add((int)i, keyboardButtons[i].rect);
+    }
+    cipherWidgets.add(BACK_WIDGET, backButtonRect);
+    cipherWidgets.add(ENTER_WIDGET, enterButtonRect);
+}
+
+WidgetRegistry *Decoding::widgetsFor(GameState state)
+{
+    switch (state)
+    {
+    case MAIN_MENU:
+        return &menuWidgets;
+    case INSTRUCTIONS_SCREEN:
+        return &instructionWidgets;
+    case CIPHER_TEXT:
+        return &cipherWidgets;
+    default:
+        return nullptr;
+    }
+}
+
 Decoding::~Decoding()
 {
     close();
@@ -152,64 +220,181 @@ bool Decoding::init()
         cout << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << "\n";
         return false;
     }
+    ttfStarted = true;
 
-    gFont = TTF_OpenFont("Kanit-Medium.ttf", 28);
-    if (gFont == nullptr)
+    if (!glyphs.init(dRenderer, loadSdfFont("Kanit-Medium.ttf"), DEFAULT_FONT_SIZE))
     {
         cout << "Failed to load font! SDL_ttf Error: " << TTF_GetError() << "\n";
         return false;
     }
 
+    if (uiAtlas.load(dRenderer, "images/atlas_ui.txt", "textFiles/atlas_ui.txt"))
+    {
+        uiAtlas.releasePixels();
+        closeSprite = uiAtlas.find("x");
+    }
+
     return true;
 }
 
+// run() closes on a loss and the destructor always does, so a second call
+// finds everything nulled and only the first drops the SDL_ttf reference.
 void Decoding::close()
 {
-    SDL_DestroyRenderer(dRenderer);
-    SDL_DestroyWindow(dWindow);
-    TTF_CloseFont(gFont);
-    TTF_Quit();
+    destroyKeyboardLayer();
+    glyphs.free();
+    uiAtlas.free();
+    textures.clear();
+    if (dRenderer != nullptr)
+    {
+        SDL_DestroyRenderer(dRenderer);
+        dRenderer = nullptr;
+    }
+    if (dWindow != nullptr)
+    {
+        SDL_DestroyWindow(dWindow);
+        dWindow = nullptr;
+    }
+    if (ttfStarted)
+    {
+        TTF_Quit();
+        ttfStarted = false;
+    }
 }
 
 void Decoding::renderText(const string &text, int x, int y, SDL_Color textColor)
 {
-    SDL_Surface *textSurface = TTF_RenderText_Solid(gFont, text.c_str(), textColor);
-    SDL_Texture *textTexture = SDL_CreateTextureFromSurface(dRenderer, textSurface);
-    int textWidth = textSurface->w;
-    int textHeight = textSurface->h;
+    glyphs.drawText(text, text.length(), x, y, textColor);
+}
 
-    SDL_Rect renderQuad = {x, y, textWidth, textHeight};
-    SDL_RenderCopy(dRenderer, textTexture, NULL, &renderQuad);
+// Key backgrounds and borders go into the batch; the labels are glyph
+// copies and are drawn by drawKeyLabels once the batch has been flushed.
+void Decoding::queueKeys(const vector<KeyButton> &keyboardButtons, int offsetX, int offsetY, SDL_Color fillColor)
+{
+    int borderWidth = 2;
+
+    for (const auto &button : keyboardButtons)
+    {
+        SDL_Rect keyRect = {button.rect.x + offsetX, button.rect.y + offsetY, button.rect.w, button.rect.h};
+        batch.fillRect(keyRect, fillColor);
 
-    SDL_FreeSurface(textSurface);
-    SDL_DestroyTexture(textTexture);
+        SDL_Rect borderRect = {
+            keyRect.x - borderWidth,
+            keyRect.y - borderWidth,
+            keyRect.w + 2 * borderWidth,
+            keyRect.h + 2 * borderWidth};
+        batch.outlineRect(borderRect, {255, 255, 255, 255});
+    }
 }
 
-void Decoding::renderVirtualKeyboard(const vector<KeyButton> &keyboardButtons)
+void Decoding::drawKeyLabels(const vector<KeyButton> &keyboardButtons, int offsetX, int offsetY)
 {
-    int borderWidth = 2; 
+    for (const auto &button : keyboardButtons)
+    {
+        int x = button.rect.x + offsetX + button.rect.w / 2 - 10;
+        int y = button.rect.y + offsetY + button.rect.h / 2 - 20;
+        renderText(button.text, x, y, {255, 255, 255, 255});
+    }
+}
 
+// The layer holds three copies of the keyboard stacked vertically: the idle
+// keyboard, then every key in its hovered style, then every key pressed.
+// A hovered or pressed key is drawn by copying its rect out of band 1 or 2.
+bool Decoding::buildKeyboardLayer(const vector<KeyButton> &keyboardButtons)
+{
+    if (keyboardButtons.empty() || !SDL_RenderTargetSupported(dRenderer))
+    {
+        return false;
+    }
+
+    int borderWidth = 2;
+    keyboardBounds = keyboardButtons[0].rect;
     for (const auto &button : keyboardButtons)
     {
-        SDL_SetRenderDrawColor(dRenderer, 80, 0, 0, 255);
-        SDL_RenderFillRect(dRenderer, &button.rect);
+        SDL_UnionRect(&keyboardBounds, &button.rect, &keyboardBounds);
+    }
+    keyboardBounds.x -= borderWidth;
+    keyboardBounds.y -= borderWidth;
+    keyboardBounds.w += 2 * borderWidth;
+    keyboardBounds.h += 2 * borderWidth;
 
-        SDL_SetRenderDrawColor(dRenderer, 255, 255, 255, 255); 
+    keyboardLayer = SDL_CreateTexture(dRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, keyboardBounds.w, keyboardBounds.h * 3);
+    if (keyboardLayer == nullptr)
+    {
+        cout << "Unable to create keyboard layer! SDL_Error: " << SDL_GetError() << "\n";
+        return false;
+    }
+    SDL_SetTextureBlendMode(keyboardLayer, SDL_BLENDMODE_BLEND);
+
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(dRenderer);
+    SDL_SetRenderTarget(dRenderer, keyboardLayer);
+    SDL_SetRenderDrawColor(dRenderer, 0, 0, 0, 0);
+    SDL_RenderClear(dRenderer);
+
+    batch.begin(dRenderer);
+    queueKeys(keyboardButtons, -keyboardBounds.x, -keyboardBounds.y, {80, 0, 0, 255});
+    queueKeys(keyboardButtons, -keyboardBounds.x, keyboardBounds.h - keyboardBounds.y, {130, 20, 20, 255});
+    queueKeys(keyboardButtons, -keyboardBounds.x, 2 * keyboardBounds.h - keyboardBounds.y, {190, 140, 40, 255});
+    batch.end();
+    batch.report("Keyboard layer");
+    for (int band = 0; band < 3; ++band)
+    {
+        drawKeyLabels(keyboardButtons, -keyboardBounds.x, band * keyboardBounds.h - keyboardBounds.y);
+    }
 
-        SDL_Rect borderRect = {
-            button.rect.x - borderWidth,
-            button.rect.y - borderWidth,
-            button.rect.w + 2 * borderWidth,
-            button.rect.h + 2 * borderWidth};
-        SDL_RenderDrawRect(dRenderer, &borderRect);
+    SDL_SetRenderTarget(dRenderer, previousTarget);
+    return true;
+}
 
-        renderText(button.text, button.rect.x + button.rect.w / 2 - 10, button.rect.y + button.rect.h / 2 - 20, {255, 255, 255, 255});
+void Decoding::destroyKeyboardLayer()
+{
+    if (keyboardLayer != nullptr)
+    {
+        SDL_DestroyTexture(keyboardLayer);
+        keyboardLayer = nullptr;
     }
 }
 
+void Decoding::renderVirtualKeyboard(const vector<KeyButton> &keyboardButtons)
+{
+    if (keyboardLayer == nullptr && !buildKeyboardLayer(keyboardButtons))
+    {
+        batch.begin(dRenderer);
+        queueKeys(keyboardButtons, 0, 0, {80, 0, 0, 255});
+        batch.end();
+        drawKeyLabels(keyboardButtons, 0, 0);
+        return;
+    }
+
+    // The idle keyboard and the hover/press overlays all come from the same
+    // layer texture, so they go out as one geometry call.
+    batch.begin(dRenderer);
+    SDL_Rect idleBand = {0, 0, keyboardBounds.w, keyboardBounds.h};
+    batch.draw(keyboardLayer, &idleBand, keyboardBounds);
+
+    int overlayKeys[2] = {cipherWidgets.hovered(), cipherWidgets.pressed()};
+    for (int band = 1; band <= 2; ++band)
+    {
+        int key = overlayKeys[band - 1];
+        if (key < 0 || (size_t)key >= keyboardButtons.size())
+        {
+            continue;
+        }
+
+        int borderWidth = 2;
+        SDL_Rect dest = {keyboardButtons[key].rect.x - borderWidth, keyboardButtons[key].rect.y - borderWidth,
+                         keyboardButtons[key].rect.w + 2 * borderWidth, keyboardButtons[key].rect.h + 2 * borderWidth};
+        SDL_Rect src = {dest.x - keyboardBounds.x, dest.y - keyboardBounds.y + band * keyboardBounds.h, dest.w, dest.h};
+        batch.draw(keyboardLayer, &src, dest);
+    }
+    batch.end();
+}
+
+// The background comes from the texture cache, so the popup decodes its
+// image once instead of on every frame it is shown.
 bool Decoding::renderPopup(const string &message, int popupWidth, int popupHeight)
 {
-    SDL_Texture *popupTexture = IMG_LoadTexture(dRenderer, "images/popup_bg.png");
+    SharedTexture popupTexture = textures.load(dRenderer, "images/popup_bg.png");
 
     if (popupTexture == nullptr)
     {
@@ -219,25 +404,20 @@ bool Decoding::renderPopup(const string &message, int popupWidth, int popupHeigh
 
     SDL_Rect popupRect = {SCWidth / 2 - popupWidth / 2, SCHeight / 2 - popupHeight / 2, popupWidth, popupHeight};
 
-    SDL_RenderCopy(dRenderer, popupTexture, NULL, &popupRect);
+    SDL_RenderCopy(dRenderer, popupTexture->getTexture(), NULL, &popupRect);
 
     renderText(message, popupRect.x + 10, popupRect.y + 10, {255, 255, 255, 255});
 
-    SDL_Texture *closeButtonTexture = IMG_LoadTexture(dRenderer, "images/x.png");
-
-    if (closeButtonTexture == nullptr)
+    if (closeSprite < 0)
     {
-        cout << "Failed to load close button image! SDL_Error: " << SDL_GetError() << "\n";
-        SDL_DestroyTexture(popupTexture);
+        cout << "Close button sprite is missing from the atlas!\n";
         return false;
     }
 
     int closeButtonSize = 30;
     SDL_Rect closeButtonRect = {popupRect.x + popupRect.w - closeButtonSize - 20, popupRect.y + 10, closeButtonSize, closeButtonSize};
-    SDL_RenderCopy(dRenderer, closeButtonTexture, NULL, &closeButtonRect);
+    uiAtlas.render(dRenderer, closeSprite, closeButtonRect);
 
-    SDL_DestroyTexture(popupTexture);
-    SDL_DestroyTexture(closeButtonTexture);
     if (mouseX >= closeButtonRect.x && mouseX <= closeButtonRect.x + closeButtonRect.w &&
         mouseY >= closeButtonRect.y && mouseY <= closeButtonRect.y + closeButtonRect.h)
     {
@@ -259,26 +439,7 @@ string Decoding::toLowerCase(const string &str)
 
 string Decoding::encodeCaesarCipher(const string &plainText, int shift)
 {
-    string encodedText = "";
-
-    for (char c : plainText)
-    {
-        if (isalpha(c))
-        {
-            char base = (isupper(c)) ? 'A' : 'a';
-            encodedText += (c - base + shift) % 26 + base;
-        }
-        else if (c == ' ')
-        {
-            encodedText += ' ';
-        }
-        else
-        {
-            encodedText += c;
-        }
-    }
-
-    return encodedText;
+    return CaesarCipher(shift).encode(plainText);
 }
 
 string Decoding::reverseWithStack(const string &message)
@@ -298,48 +459,51 @@ string Decoding::reverseWithStack(const string &message)
 
     return reversedMessage;
 }
+// Puzzles come from the pack built by tools/puzzleGen (make puzzles); the
+// four built-in words are only used when the pack is missing or was built
+// with keys the instructions do not give.
+void Decoding::pickPuzzle(string &originalText, string &cipheredText)
+{
+    Puzzle puzzle;
+    uint32_t random = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    if (puzzles.sample(random, puzzle) && puzzle.cipher == PUZZLE_CAESAR && puzzle.key == DECODING_SHIFT)
+    {
+        originalText = string(puzzle.plainText);
+        cipheredText = string(puzzle.cipherText);
+        return;
+    }
+    originalText = wordArray[rand() % 4];
+    cipheredText = encodeCaesarCipher(originalText, DECODING_SHIFT);
+}
+
 string Decoding::run()
 {
     SDL_Event e;
     bool quit = false;
     GameState currentState = MAIN_MENU;
-    bool textFullyTyped = false;
     string typedText = "";
     string selectedWords = "";
     string enteredText = "";
     string reversedText = "";
-    SDL_Texture *popupTexture = IMG_LoadTexture(dRenderer, "images/popup_bg.png");
-    if (popupTexture == nullptr)
+    if (textures.load(dRenderer, "images/popup_bg.png") == nullptr)
     {
         cout << "Failed to load pop-up background image! SDL_Error: " << SDL_GetError() << "\n";
     }
-    SDL_Texture *closeButtonTexture = IMG_LoadTexture(dRenderer, "images/x.png");
-    if (closeButtonTexture == nullptr)
-    {
-        cout << "Failed to load close button image! SDL_Error: " << SDL_GetError() << "\n";
-        SDL_DestroyTexture(popupTexture);
-    }
     SDL_Texture *mainMenuBackgroundTexture = IMG_LoadTexture(dRenderer, "images/cipherBg2.png");
     if (mainMenuBackgroundTexture == nullptr)
     {
         cout << "Failed to load main menu background image! SDL_Error: " << SDL_GetError() << "\n";
-        SDL_DestroyTexture(popupTexture);
-        SDL_DestroyTexture(closeButtonTexture);
     }
     SDL_Texture *InstructionScreenTexture = IMG_LoadTexture(dRenderer, "images/cipherbg3.png");
     if (InstructionScreenTexture == nullptr)
     {
         cout << "Failed to load main menu background image! SDL_Error: " << SDL_GetError() << "\n";
-        SDL_DestroyTexture(popupTexture);
-        SDL_DestroyTexture(closeButtonTexture);
         SDL_DestroyTexture(mainMenuBackgroundTexture);
     }
     SDL_Texture *cipherScreenBackgroundTexture = IMG_LoadTexture(dRenderer, "images/cipherbg1.png");
     if (cipherScreenBackgroundTexture == nullptr)
     {
         cout << "Failed to load cipher screen background image! SDL_Error: " << SDL_GetError() << "\n";
-        SDL_DestroyTexture(popupTexture);
-        SDL_DestroyTexture(closeButtonTexture);
         SDL_DestroyTexture(InstructionScreenTexture);
         SDL_DestroyTexture(mainMenuBackgroundTexture);
     }
@@ -347,8 +511,6 @@ string Decoding::run()
     if (newScreenTexture == nullptr)
     {
         cout << "Failed to load new screen image! SDL_Error: " << SDL_GetError() << "\n";
-        SDL_DestroyTexture(popupTexture);
-        SDL_DestroyTexture(closeButtonTexture);
         SDL_DestroyTexture(InstructionScreenTexture);
         SDL_DestroyTexture(mainMenuBackgroundTexture);
         SDL_DestroyTexture(cipherScreenBackgroundTexture);
@@ -358,18 +520,14 @@ string Decoding::run()
     {
         cout << "Failed to load new screen image! SDL_Error: " << SDL_GetError() << "\n";
         SDL_DestroyTexture(lostScreenTexture);
-        SDL_DestroyTexture(popupTexture);
-        SDL_DestroyTexture(closeButtonTexture);
         SDL_DestroyTexture(InstructionScreenTexture);
         SDL_DestroyTexture(mainMenuBackgroundTexture);
         SDL_DestroyTexture(cipherScreenBackgroundTexture);
     }
     int count = 0;
-    int shift = 3;
     srand(time(nullptr));
-    int randomIndex = rand() % 4; 
-    string originalText = wordArray[randomIndex];
-    string cipheredText = encodeCaesarCipher(originalText, shift);
+    string originalText, cipheredText;
+    pickPuzzle(originalText, cipheredText);
     while (!quit)
     {
         while (SDL_PollEvent(&e) != 0)
@@ -385,101 +543,103 @@ string Decoding::run()
                     quit = true; 
                 }
             }
-            else if (e.type == SDL_MOUSEBUTTONDOWN)
+            else if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET)
             {
-                if (e.button.button == SDL_BUTTON_LEFT)
+                destroyKeyboardLayer();
+            }
+            else if (e.type == SDL_MOUSEMOTION || e.type == SDL_MOUSEBUTTONDOWN || e.type == SDL_MOUSEBUTTONUP)
+            {
+                WidgetRegistry *widgets = widgetsFor(currentState);
+                int clicked = (widgets != nullptr) ? widgets->handleEvent(e) : -1;
+                if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT)
                 {
-                    SDL_GetMouseState(&mouseX, &mouseY);
+                    mouseX = e.button.x;
+                    mouseY = e.button.y;
+                }
 
-                    if (currentState == MAIN_MENU)
+                if (currentState == MAIN_MENU)
+                {
+                    if (clicked == START_WIDGET)
                     {
-                        if (mouseX >= startButtonRect.x && mouseX <= startButtonRect.x + startButtonRect.w &&
-                            mouseY >= startButtonRect.y && mouseY <= startButtonRect.y + startButtonRect.h)
-                        {
-                            currentState = CIPHER_TEXT;
-                        }
-                        if (mouseX >= instructButtonRect.x && mouseX <= instructButtonRect.x + instructButtonRect.w &&
-                            mouseY >= instructButtonRect.y && mouseY <= instructButtonRect.y + instructButtonRect.h)
-                        {
-                            currentState = INSTRUCTIONS_SCREEN;
-                        }
+                        currentState = CIPHER_TEXT;
+                        cipherReveal.start(cipheredText, TEXT_TYPING_SPEED);
                     }
-                    else if (currentState == INSTRUCTIONS_SCREEN)
+                    else if (clicked == INSTRUCT_WIDGET)
                     {
-                        
-                        if (mouseX >= backButtonRect.x && mouseX <= backButtonRect.x + backButtonRect.w &&
-                            mouseY >= backButtonRect.y && mouseY <= backButtonRect.y + backButtonRect.h)
-                        {
-                            currentState = MAIN_MENU; 
-                        }
+                        currentState = INSTRUCTIONS_SCREEN;
                     }
-                    else if (currentState == CIPHER_TEXT)
+                }
+                else if (currentState == INSTRUCTIONS_SCREEN)
+                {
+                    if (clicked == BACK_WIDGET)
+                    {
+                        currentState = MAIN_MENU;
+                    }
+                }
+                else if (currentState == CIPHER_TEXT)
+                {
+                    if (clicked == BACK_WIDGET)
                     {
-                        if (mouseX >= backButtonRect.x && mouseX <= backButtonRect.x + backButtonRect.w &&
-                            mouseY >= backButtonRect.y && mouseY <= backButtonRect.y + backButtonRect.h)
+                        currentState = MAIN_MENU;
+                        pickPuzzle(originalText, cipheredText);
+                    }
+                    else if (clicked == ENTER_WIDGET)
+                    {
+                        cout << "Enter button clicked!" << endl;
+                        enteredText = typedText;
+                        cout << enteredText << endl;
+                        if (toLowerCase(originalText) == toLowerCase(enteredText))
                         {
-                            currentState = MAIN_MENU; 
-                            randomIndex = rand() % 4; 
-                            originalText = wordArray[randomIndex];
+                            currentState = STACK_SCREEN;
+                            passwordReveal.start("Password to the next door is: ", TEXT_TYPING_SPEED);
+                            textDecoded = true;
+                            cout << "Here's your first passowrd" << endl;
                         }
-                        else if (mouseX >= enterButtonRect.x && mouseX <= enterButtonRect.x + enterButtonRect.w &&
-                                 mouseY >= enterButtonRect.y && mouseY <= enterButtonRect.y + enterButtonRect.h)
+                        else
                         {
-                            cout << "Enter button clicked!" << endl;
-                            enteredText = typedText;
-                            cout << enteredText << endl;
-                            if (toLowerCase(originalText) == toLowerCase(enteredText))
+                            cout << "Wrong! Try again.\n";
+                            count++;
+                            if (count < 3)
                             {
-                                currentState = STACK_SCREEN;
-                                textDecoded = true;
-                                cout << "Here's your first passowrd" << endl;
+                                displayPopup = true;
+                                typedText = "";
+                                selectedWords = "";
                             }
                             else
                             {
-                                cout << "Wrong! Try again.\n";
-                                count++;
-                                if (count < 3)
-                                {
-                                    displayPopup = true;
-                                    typedText = "";
-                                    selectedWords = "";
-                                }
-                                else
-                                {
-                                    currentState = YOU_LOST;
-                                    textDecoded = false;
-                                }
+                                currentState = YOU_LOST;
+                                textDecoded = false;
                             }
                         }
+                    }
+                    else if (clicked >= 0 && (size_t)clicked < keyboardButtons.size())
+                    {
+                        const KeyButton &button = keyboardButtons[clicked];
 
-                        for (const auto &button : keyboardButtons)
+                        if (button.text == "<=" && !selectedWords.empty())
                         {
-                            if (mouseX >= button.rect.x && mouseX <= button.rect.x + button.rect.w &&
-                                mouseY >= button.rect.y && mouseY <= button.rect.y + button.rect.h)
-                            {
-
-                                if (button.text == "<=" && !selectedWords.empty())
-                                {
-                                    typedText = typedText.substr(0, typedText.length() - 1);
-                                    selectedWords = selectedWords.substr(0, selectedWords.length() - 1);
-                                }
-                                else if (button.text == " " && button.text.length() == 1)
-                                {
-                                    typedText += ' ';
-                                    selectedWords += ' ';
-                                }
-                                else if (button.text.length() == 1)
-                                {
-                                    typedText += button.text;
-                                    selectedWords += button.text;
-                                }
-                            }
+                            typedText = typedText.substr(0, typedText.length() - 1);
+                            selectedWords = selectedWords.substr(0, selectedWords.length() - 1);
+                        }
+                        else if (button.text == " " && button.text.length() == 1)
+                        {
+                            typedText += ' ';
+                            selectedWords += ' ';
+                        }
+                        else if (button.text.length() == 1)
+                        {
+                            typedText += button.text;
+                            selectedWords += button.text;
                         }
                     }
                 }
             }
         }
 
+        Uint32 now = SDL_GetTicks();
+        cipherReveal.update(now);
+        passwordReveal.update(now);
+
         SDL_SetRenderDrawColor(dRenderer, 255, 255, 255, 255);
         SDL_RenderClear(dRenderer);
         if (currentState == MAIN_MENU)
@@ -489,11 +649,10 @@ string Decoding::run()
         if (currentState == INSTRUCTIONS_SCREEN)
         {
             SDL_RenderCopy(dRenderer, InstructionScreenTexture, NULL, NULL);
-            SDL_SetRenderDrawColor(dRenderer, 80, 0, 0, 255);
-            SDL_RenderFillRect(dRenderer, &backButtonRect);
-
-            SDL_SetRenderDrawColor(dRenderer, 255, 255, 255, 255);
-            SDL_RenderDrawRect(dRenderer, &backButtonRect);
+            batch.begin(dRenderer);
+            batch.fillRect(backButtonRect, {80, 0, 0, 255});
+            batch.outlineRect(backButtonRect, {255, 255, 255, 255});
+            batch.end();
 
             renderText("Back", 29, SCHeight - 53, {255, 255, 255, 255});
         }
@@ -501,39 +660,20 @@ string Decoding::run()
         {
             SDL_RenderCopy(dRenderer, cipherScreenBackgroundTexture, NULL, NULL);
 
-            SDL_SetRenderDrawColor(dRenderer, 80, 0, 0, 255);
-            SDL_RenderFillRect(dRenderer, &backButtonRect);
-
-            SDL_SetRenderDrawColor(dRenderer, 255, 255, 255, 255);
-            SDL_RenderDrawRect(dRenderer, &backButtonRect);
+            batch.begin(dRenderer);
+            batch.fillRect(backButtonRect, {80, 0, 0, 255});
+            batch.outlineRect(backButtonRect, {255, 255, 255, 255});
+            batch.fillRect(enterButtonRect, {80, 0, 0, 255});
+            batch.outlineRect(enterButtonRect, {255, 255, 255, 255});
+            batch.end();
+            batch.report("Cipher screen buttons");
 
             renderText("Back", 29, SCHeight - 53, {255, 255, 255, 255});
-
-            SDL_SetRenderDrawColor(dRenderer, 80, 0, 0, 255);
-            SDL_RenderFillRect(dRenderer, &enterButtonRect);
-
-            SDL_SetRenderDrawColor(dRenderer, 255, 255, 255, 255);
-            SDL_RenderDrawRect(dRenderer, &enterButtonRect);
-
             renderText("Enter", SCWidth - 115, SCHeight - 110, {255, 255, 255, 255});
 
-            if (textFullyTyped)
-            {
-                renderText("Ciphered Text: " + cipheredText, 50, 50, {200, 200, 200, 255});
-            }
-            else
-            {
-                string partialText;
-                for (int i = 0; i < cipheredText.length(); ++i)
-                {
-                    partialText += cipheredText[i];
-                    renderText("Ciphered Text: " + partialText, 50, 50, {200, 200, 200, 255});
-                    SDL_RenderPresent(dRenderer);
-                    this_thread::sleep_for(chrono::milliseconds(TEXT_TYPING_SPEED));
-                }
-
-                textFullyTyped = true;
-            }
+            string cipherLabel = "Ciphered Text: ";
+            int labelWidth = glyphs.drawText(cipherLabel, cipherLabel.length(), 50, 50, {200, 200, 200, 255});
+            cipherReveal.render(glyphs, 50 + labelWidth, 50, {200, 200, 200, 255});
 
             renderText("Selected Words: " + selectedWords, 50, SCHeight - 150, {200, 200, 200, 255});
             renderVirtualKeyboard(keyboardButtons);
@@ -554,30 +694,7 @@ string Decoding::run()
             SDL_Rect imageRect = {0, 0, screenWidth, screenHeight};
             SDL_RenderCopy(dRenderer, newScreenTexture, NULL, &imageRect);
 
-            bool typewriterEffectDone = false;
-            string Text = "Password to the next door is: ";
-            int textLength = Text.length();
-            static int charactersTyped = 0;
-
-            if (!typewriterEffectDone && charactersTyped < textLength)
-            {
-                string partialText = Text.substr(0, charactersTyped + 1);
-                renderText(partialText, screenWidth / 2 - 180, screenHeight / 2 - 25, {255, 255, 255, 255});
-                SDL_RenderPresent(dRenderer);
-                this_thread::sleep_for(chrono::milliseconds(TEXT_TYPING_SPEED));
-
-                charactersTyped++;
-
-                if (charactersTyped == textLength)
-                {
-                    typewriterEffectDone = true;
-                }
-            }
-
-            if (charactersTyped >= textLength)
-            {
-                renderText(Text, screenWidth / 2 - 180, screenHeight / 2 - 25, {255, 255, 255, 255});
-            }
+            passwordReveal.render(glyphs, screenWidth / 2 - 180, screenHeight / 2 - 25, {255, 255, 255, 255});
 
             reversedText = reverseWithStack(enteredText);
             renderText("PASSWORD: " + reversedText, screenWidth / 2 - 180, screenHeight / 2 + 25, {255, 255, 255, 255});
@@ -594,15 +711,15 @@ string Decoding::run()
         
     }
     
-    if (!textDecoded)
-    {
-        close();
-    }
-    
+    // The screen textures go before close() destroys their renderer.
     SDL_DestroyTexture(lostScreenTexture);
     SDL_DestroyTexture(newScreenTexture);
     SDL_DestroyTexture(mainMenuBackgroundTexture);
     SDL_DestroyTexture(cipherScreenBackgroundTexture);
+    if (!textDecoded)
+    {
+        close();
+    }
     return reversedText;
 }
 bool Decoding::successfulDecoding(){
@@ -0,0 +1,348 @@
+#ifndef GLYPHCACHE_HPP
+#define GLYPHCACHE_HPP
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include "sdfFont.hpp"
+#include "skylinePacker.hpp"
+#include "spriteBatch.hpp"
+using namespace std;
+
+// Bitmap font for one (font, size): init() rasterizes every printable ASCII
+// glyph once, in white, and packs them into a single atlas page texture.
+// Strings are then drawn as quads cut from that page, tinted to the requested
+// colour and placed with the cached advances and kerning, so changing text
+// never rasterizes or uploads anything. Each run is one SDL_RenderGeometry
+// call; beginBatch()/endBatch() around several runs make them one call too.
+// The glyphs come either from FreeType for one opened font, or from the
+// font's shared distance field at any point size (see sdfFont.hpp). Either
+// way every metric is resolved by init(), so the font may be closed (and
+// SDL_ttf shut down) as soon as it returns.
+class GlyphCache
+{
+public:
+    GlyphCache();
+    ~GlyphCache();
+    GlyphCache(const GlyphCache &) = delete;
+    GlyphCache &operator=(const GlyphCache &) = delete;
+    bool init(SDL_Renderer *renderer, TTF_Font *font);
+    bool init(SDL_Renderer *renderer, const SdfFont *font, int pointSize);
+    void free();
+    void beginBatch();
+    void endBatch();
+    int drawText(const string &text, size_t count, int x, int y, SDL_Color color);
+    int drawRun(string_view text, size_t start, size_t count, int x, int y, SDL_Color color);
+    int measureText(const string &text, size_t count);
+    int measureRun(string_view text, size_t start, size_t count);
+    int advance(char c);
+    int kerning(char previous, char c);
+    int lineHeight() const;
+    SDL_Texture *getPage() const;
+
+private:
+    static const int FIRST_GLYPH = 32;
+    static const int LAST_GLYPH = 126;
+    static const int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+    static const int GLYPH_PADDING = 1;
+    static const int MAX_PAGE_SIDE = 4096;
+
+    struct Glyph
+    {
+        SDL_Rect source;
+        int advance;
+    };
+
+    SDL_Renderer *mRenderer;
+    SDL_Texture *mPage;
+    int mLineHeight;
+    Glyph mGlyphs[GLYPH_COUNT];
+    short mKerning[GLYPH_COUNT][GLYPH_COUNT];
+    SpriteBatch mBatch;
+    int mBatchDepth;
+
+    const Glyph *glyph(char c) const;
+    void reset(SDL_Renderer *renderer);
+    bool buildPage(SDL_Surface *bitmaps[GLYPH_COUNT]);
+};
+
+GlyphCache::GlyphCache()
+{
+    mRenderer = NULL;
+    mPage = NULL;
+    mLineHeight = 0;
+    mBatchDepth = 0;
+    for (int i = 0; i < GLYPH_COUNT; ++i)
+    {
+        mGlyphs[i] = {{0, 0, 0, 0}, 0};
+    }
+}
+
+GlyphCache::~GlyphCache()
+{
+    free();
+}
+
+void GlyphCache::reset(SDL_Renderer *renderer)
+{
+    free();
+    mRenderer = renderer;
+    for (int i = 0; i < GLYPH_COUNT; ++i)
+    {
+        for (int j = 0; j < GLYPH_COUNT; ++j)
+        {
+            mKerning[i][j] = 0;
+        }
+    }
+}
+
+// Renders each glyph the way the old per-glyph textures were made: one
+// blended character, so the bitmap carries its bearing and the font's line
+// height. The whole kerning table is looked up here too.
+bool GlyphCache::init(SDL_Renderer *renderer, TTF_Font *font)
+{
+    reset(renderer);
+    if (mRenderer == NULL || font == NULL)
+    {
+        return false;
+    }
+    mLineHeight = TTF_FontHeight(font);
+    SDL_Surface *bitmaps[GLYPH_COUNT];
+    for (int i = 0; i < GLYPH_COUNT; ++i)
+    {
+        char c = (char)(FIRST_GLYPH + i);
+        int minX, maxX, minY, maxY;
+        if (TTF_GlyphMetrics32(font, (Uint32)c, &minX, &maxX, &minY, &maxY, &mGlyphs[i].advance) != 0)
+        {
+            mGlyphs[i].advance = 0;
+        }
+        for (int j = 0; j < GLYPH_COUNT; ++j)
+        {
+            mKerning[i][j] = (short)TTF_GetFontKerningSizeGlyphs32(font, (Uint32)c, (Uint32)(FIRST_GLYPH + j));
+        }
+        char text[2] = {c, '\0'};
+        bitmaps[i] = (c == ' ') ? NULL : TTF_RenderText_Blended(font, text, {255, 255, 255, 255});
+    }
+    return buildPage(bitmaps);
+}
+
+// Same layout from a distance field: metrics are the field's scaled to
+// pointSize and rounded to whole pixels, as FreeType would give them.
+bool GlyphCache::init(SDL_Renderer *renderer, const SdfFont *font, int pointSize)
+{
+    reset(renderer);
+    if (mRenderer == NULL || font == NULL)
+    {
+        return false;
+    }
+    float scale = font->scaleFor(pointSize);
+    mLineHeight = (int)lroundf(font->lineHeight() * scale);
+    SDL_Surface *bitmaps[GLYPH_COUNT];
+    for (int i = 0; i < GLYPH_COUNT; ++i)
+    {
+        mGlyphs[i].advance = (int)lroundf(font->advance(i) * scale);
+        for (int j = 0; j < GLYPH_COUNT; ++j)
+        {
+            mKerning[i][j] = (short)lroundf(font->kerning(i, j) * scale);
+        }
+        bitmaps[i] = font->renderGlyph(i, scale);
+    }
+    return buildPage(bitmaps);
+}
+
+// Packs the bitmaps tallest first on a page that doubles until they fit,
+// uploads the page once and frees the bitmaps.
+bool GlyphCache::buildPage(SDL_Surface *bitmaps[GLYPH_COUNT])
+{
+    int order[GLYPH_COUNT];
+    for (int i = 0; i < GLYPH_COUNT; ++i)
+    {
+        order[i] = i;
+    }
+    sort(order, order + GLYPH_COUNT, [&](int a, int b) {
+        return (bitmaps[a] ? bitmaps[a]->h : 0) > (bitmaps[b] ? bitmaps[b]->h : 0);
+    });
+
+    SkylinePacker packer;
+    int side = 128;
+    bool packed = false;
+    while (!packed && side <= MAX_PAGE_SIDE)
+    {
+        packer.reset(side, side, GLYPH_PADDING);
+        packed = true;
+        for (int i : order)
+        {
+            mGlyphs[i].source = {0, 0, 0, 0};
+            if (bitmaps[i] != NULL && !packer.insert(bitmaps[i]->w, bitmaps[i]->h, mGlyphs[i].source))
+            {
+                packed = false;
+                side *= 2;
+                break;
+            }
+        }
+    }
+
+    SDL_Surface *page = packed ? SDL_CreateRGBSurfaceWithFormat(0, side, max(1, packer.getUsedHeight()), 32, SDL_PIXELFORMAT_ARGB8888) : NULL;
+    if (page != NULL)
+    {
+        SDL_FillRect(page, NULL, SDL_MapRGBA(page->format, 255, 255, 255, 0));
+    }
+    for (int i = 0; i < GLYPH_COUNT; ++i)
+    {
+        if (bitmaps[i] == NULL)
+        {
+            continue;
+        }
+        if (page != NULL)
+        {
+            // Copy the coverage as is instead of blending it onto the page.
+            SDL_SetSurfaceBlendMode(bitmaps[i], SDL_BLENDMODE_NONE);
+            SDL_Rect dest = mGlyphs[i].source;
+            SDL_BlitSurface(bitmaps[i], NULL, page, &dest);
+        }
+        SDL_FreeSurface(bitmaps[i]);
+    }
+    if (page == NULL)
+    {
+        cout << "Unable to build glyph atlas! SDL Error: " << SDL_GetError() << endl;
+        return false;
+    }
+
+    mPage = SDL_CreateTextureFromSurface(mRenderer, page);
+    SDL_FreeSurface(page);
+    if (mPage == NULL)
+    {
+        cout << "Unable to create glyph atlas texture! SDL Error: " << SDL_GetError() << endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(mPage, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void GlyphCache::free()
+{
+    if (mPage != NULL)
+    {
+        SDL_DestroyTexture(mPage);
+        mPage = NULL;
+    }
+    for (int i = 0; i < GLYPH_COUNT; ++i)
+    {
+        mGlyphs[i] = {{0, 0, 0, 0}, 0};
+    }
+    mLineHeight = 0;
+    mBatchDepth = 0;
+}
+
+const GlyphCache::Glyph *GlyphCache::glyph(char c) const
+{
+    int index = (unsigned char)c - FIRST_GLYPH;
+    if (mLineHeight == 0 || index < 0 || index >= GLYPH_COUNT)
+    {
+        return NULL;
+    }
+    return &mGlyphs[index];
+}
+
+int GlyphCache::advance(char c)
+{
+    const Glyph *g = glyph(c);
+    return g != NULL ? g->advance : 0;
+}
+
+int GlyphCache::kerning(char previous, char c)
+{
+    int i = (unsigned char)previous - FIRST_GLYPH;
+    int j = (unsigned char)c - FIRST_GLYPH;
+    if (mLineHeight == 0 || i < 0 || i >= GLYPH_COUNT || j < 0 || j >= GLYPH_COUNT)
+    {
+        return 0;
+    }
+    return mKerning[i][j];
+}
+
+int GlyphCache::lineHeight() const
+{
+    return mLineHeight;
+}
+
+SDL_Texture *GlyphCache::getPage() const
+{
+    return mPage;
+}
+
+// Runs drawn until the matching endBatch() go out as a single geometry call.
+// Nothing else may be drawn on the renderer in between.
+void GlyphCache::beginBatch()
+{
+    if (mBatchDepth++ == 0)
+    {
+        mBatch.begin(mRenderer);
+    }
+}
+
+void GlyphCache::endBatch()
+{
+    if (mBatchDepth > 0 && --mBatchDepth == 0)
+    {
+        mBatch.end();
+    }
+}
+
+int GlyphCache::measureText(const string &text, size_t count)
+{
+    return measureRun(text, 0, count);
+}
+
+// Width of text[start, start + count), as drawRun would advance the pen.
+int GlyphCache::measureRun(string_view text, size_t start, size_t count)
+{
+    int width = 0;
+    size_t end = start + min(count, text.length() - min(start, text.length()));
+    for (size_t i = start; i < end; ++i)
+    {
+        if (i > start)
+        {
+            width += kerning(text[i - 1], text[i]);
+        }
+        width += advance(text[i]);
+    }
+    return width;
+}
+
+int GlyphCache::drawText(const string &text, size_t count, int x, int y, SDL_Color color)
+{
+    return drawRun(text, 0, count, x, y, color);
+}
+
+int GlyphCache::drawRun(string_view text, size_t start, size_t count, int x, int y, SDL_Color color)
+{
+    beginBatch();
+    int penX = x;
+    size_t end = start + min(count, text.length() - min(start, text.length()));
+    for (size_t i = start; i < end; ++i)
+    {
+        const Glyph *g = glyph(text[i]);
+        if (g == NULL)
+        {
+            continue;
+        }
+        if (i > start)
+        {
+            penX += kerning(text[i - 1], text[i]);
+        }
+        if (g->source.w > 0)
+        {
+            SDL_Rect dest = {penX, y, g->source.w, g->source.h};
+            mBatch.draw(mPage, &g->source, dest, color);
+        }
+        penX += g->advance;
+    }
+    endBatch();
+    return penX - x;
+}
+
+#endif
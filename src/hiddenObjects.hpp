@@ -1,4 +1,4 @@
-#include <map>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <random>
@@ -6,24 +6,36 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
-#include "DSA.hpp"
+#include "hitMask.hpp"
+#include "levelPack.hpp"
+#include "placement.hpp"
+#include "sceneIndex.hpp"
+#include "spriteBatch.hpp"
+#include "textLayout.hpp"
+#include "textureAtlas.hpp"
 #include "potionGame.hpp"
 
 using namespace std;
 SDL_Window *objWindow = nullptr;
 SDL_Renderer *objRenderer = nullptr;
 TTF_Font *gFont = nullptr;
-
-Queue<string> imagePathQueue;
-map<pair<int, int>, string> imageCoordinateMap;
+bool objTtfStarted = false;
+GlyphCache titleGlyphs;
+TextureAtlas objectAtlas;
+
+// Objects, names and the required order come from the compiled level pack
+// (textFiles/levels.txt -> levels.bin). An object's id is its index in the
+// level, so a click only compares against expectedOrder[nextExpected].
+LevelPack levelPack;
+Level currentLevel = {};
+vector<int> expectedOrder;
+int nextExpected = 0;
 
 SDL_Texture *backgroundTexture1 = nullptr;
 SDL_Texture *backgroundTexture2 = nullptr;
 SDL_Texture *endTexture = nullptr;
-SDL_Rect leftSection = {0, 0, 600, 600};
+SDL_Rect leftSection = LEVEL_SCENE_AREA;
 SDL_Rect rightSection = {600, 0, 200, 600};
-const char *imagePaths[] = {
-    "knife.png", "palm.png", "letter.png", "syringe.png", "key.png"};
 
 void renderText(const string &name, int m, int n, TTF_Font *font, SDL_Color textColor)
 {
@@ -47,261 +59,309 @@ void renderText(const string &name, int m, int n, TTF_Font *font, SDL_Color text
     SDL_FreeSurface(textSurface);
     SDL_DestroyTexture(textTexture);
 }
-void wrapText(const string &text, int x, int y, bool wrapText)
+void initializeExpectedOrder()
 {
-    SDL_Color textColor = {255, 255, 255};
-    TTF_Font *font = TTF_OpenFont("Boxtoon.ttf", 25);
+    nextExpected = 0;
+    expectedOrder.assign(currentLevel.order, currentLevel.order + currentLevel.orderCount);
+}
+
+bool allObjectsFound()
+{
+    return nextExpected >= (int)expectedOrder.size();
+}
 
-    if (!font)
+typedef uint32_t ObjectHandle;
+const ObjectHandle INVALID_OBJECT = 0xffffffff;
+
+// Structure-of-arrays object store: geometry, sprite ids and a hidden bitset
+// live in parallel arrays indexed by draw order, so visibility and rect tests
+// are tight loops over plain ints. Sprites (texture plus hit mask) are shared
+// by every object that uses them. add() returns a handle that stays valid
+// until clear(); handles from before a clear() are rejected. Per-frame loops
+// (render, rectOf, isHidden) take the draw-order index behind a handle.
+class GameObjectList
+{
+public:
+    GameObjectList() : generation(0) {}
+
+    int addSprite(SDL_Texture *texture, SDL_Surface *surface)
     {
-        cout << "Failed to load font: " << TTF_GetError() << endl;
-        return;
+        textures.push_back(texture);
+        sources.push_back({0, 0, 0, 0});
+        masks.emplace_back();
+        masks.back().build(surface);
+        return (int)textures.size() - 1;
     }
 
-    if (wrapText)
+    // Atlas sprites share the page texture, so every object drawn from one
+    // atlas lands in the same batch run.
+    int addSprite(const TextureAtlas &atlas, int sprite)
     {
-        int wrapLength = 75;
-        vector<string> wrappedLines;
-
-    
-        size_t startPos = 0;
-        while (startPos < text.length())
-        {
-            size_t endPos = min(startPos + wrapLength, text.length());
-            size_t lastSpace = text.find_last_of(" ", endPos);
-            if (lastSpace != string::npos && lastSpace > startPos)
-            {
-                endPos = lastSpace;
-            }
-            wrappedLines.push_back(text.substr(startPos, endPos - startPos));
-            startPos = endPos + 1;
-        }
+        textures.push_back(atlas.getTexture());
+        sources.push_back(atlas.getRect(sprite));
+        masks.emplace_back();
+        atlas.buildHitMask(sprite, masks.back());
+        return (int)textures.size() - 1;
+    }
 
-        int yOffset = y;
-        for (const auto &line : wrappedLines)
+    ObjectHandle add(int objectId, int spriteId, int width, int height)
+    {
+        int i = (int)xs.size();
+        xs.push_back(0);
+        ys.push_back(0);
+        widths.push_back(width);
+        heights.push_back(height);
+        objectIds.push_back(objectId);
+        spriteIds.push_back(spriteId);
+        pinned.push_back(0);
+        if (i % 64 == 0)
         {
-            renderText(line, x, yOffset, font, textColor);
-            yOffset += TTF_FontHeight(font); 
+            hiddenBits.push_back(0);
         }
+        return ((ObjectHandle)generation << 24) | (ObjectHandle)i;
     }
-    else
+
+    // Textures belong to the renderer and go away with it.
+    void clear()
     {
-        renderText(text, x, y, font, textColor);
+        xs.clear();
+        ys.clear();
+        widths.clear();
+        heights.clear();
+        objectIds.clear();
+        spriteIds.clear();
+        pinned.clear();
+        hiddenBits.clear();
+        textures.clear();
+        sources.clear();
+        masks.clear();
+        index.reset(0, 0);
+        generation = (generation + 1) & 0xff;
     }
 
-    TTF_CloseFont(font);
-}
-void initializeImagePathQueue()
-{
-    ifstream imagePathFile("textFiles/image_paths.txt");
-    if (imagePathFile.is_open())
+    int size() const
     {
-        string line;
-        while (getline(imagePathFile, line))
-        {
-            if (!line.empty())
-            {
-                imagePathQueue.enqueue(line);
-            }
-        }
-        imagePathFile.close();
+        return (int)xs.size();
     }
-    else
+
+    bool isValid(ObjectHandle handle) const
     {
-        cout<< "Failed to open image_paths.txt" << endl;
+        return handle != INVALID_OBJECT && (int)(handle >> 24) == generation && (int)(handle & 0xffffff) < size();
     }
-}
-
-class GameObjectNode
-{
-public:
-    GameObjectNode(SDL_Texture *texture, int width, int height)
-        : texture(texture), x(0), y(0), width(width), height(height) {}
 
-    void render() const
+    int indexOf(ObjectHandle handle) const
     {
-        SDL_Rect destRect = {x, y, width, height};
-        SDL_RenderCopy(objRenderer, texture, nullptr, &destRect);
+        return isValid(handle) ? (int)(handle & 0xffffff) : -1;
     }
 
-    bool isClicked(int mouseX, int mouseY) const
+    ObjectHandle handleAt(int i) const
     {
-        return mouseX >= x && mouseX <= x + width && mouseY >= y && mouseY <= y + height;
+        return ((ObjectHandle)generation << 24) | (ObjectHandle)i;
     }
 
-    void hide()
+    void setPosition(ObjectHandle handle, int x, int y)
     {
-        hidden = true;
+        int i = indexOf(handle);
+        if (i >= 0)
+        {
+            xs[i] = x;
+            ys[i] = y;
+        }
     }
 
-    bool isHidden() const
+    // Pinned objects keep their position and are worked around by
+    // setRandomPositions.
+    void pin(ObjectHandle handle, int x, int y)
     {
-        return hidden;
+        int i = indexOf(handle);
+        if (i >= 0)
+        {
+            xs[i] = x;
+            ys[i] = y;
+            pinned[i] = 1;
+        }
     }
 
-    void setCoordinates(int newX, int newY)
+    SDL_Rect rectOf(int i) const
     {
-        x = newX;
-        y = newY;
+        return {xs[i], ys[i], widths[i], heights[i]};
     }
 
-public:
-    SDL_Texture *texture;
-    int x, y, width, height;
-    bool hidden = false;
-    GameObjectNode *next = nullptr;
-};
+    int objectIdOf(ObjectHandle handle) const
+    {
+        int i = indexOf(handle);
+        return i >= 0 ? objectIds[i] : -1;
+    }
 
-class GameObjectList
-{
-public:
-    ~GameObjectList()
+    bool isHidden(int i) const
     {
-        clear();
+        return (hiddenBits[i >> 6] >> (i & 63)) & 1;
     }
 
-    void addNode(GameObjectNode *newNode)
+    void hide(ObjectHandle handle)
     {
-        if (head == nullptr)
+        int i = indexOf(handle);
+        if (i >= 0)
         {
-            head = newNode;
+            hiddenBits[i >> 6] |= (uint64_t)1 << (i & 63);
+            index.hide(i);
         }
-        else
+    }
+
+    void render(int i, SpriteBatch &batch) const
+    {
+        const SDL_Rect &source = sources[spriteIds[i]];
+        batch.draw(textures[spriteIds[i]], source.w > 0 ? &source : nullptr, rectOf(i));
+    }
+
+    bool isClicked(int i, int mouseX, int mouseY) const
+    {
+        if (mouseX < xs[i] || mouseX > xs[i] + widths[i] || mouseY < ys[i] || mouseY > ys[i] + heights[i])
         {
-            newNode->next = head;
-            head = newNode;
+            return false;
         }
+        return masks[spriteIds[i]].hitScaled(mouseX - xs[i], mouseY - ys[i], widths[i], heights[i]);
     }
 
-    void clear()
+    // Indexes the objects by position. Has to run again whenever objects are
+    // added or moved.
+    void rebuildIndex()
     {
-        while (head != nullptr)
+        index.reset(leftSection.x + leftSection.w, leftSection.y + leftSection.h);
+        for (int i = 0; i < size(); ++i)
         {
-            GameObjectNode *temp = head;
-            head = head->next;
-            delete temp;
+            index.add(rectOf(i));
+            if (isHidden(i))
+            {
+                index.hide(i);
+            }
         }
     }
 
-    bool isOverlap(const SDL_Rect &rect1, const SDL_Rect &rect2)
+    ObjectHandle topmostAt(int x, int y) const
     {
-        return (rect1.x < rect2.x + rect2.w &&
-                rect1.x + rect1.w > rect2.x &&
-                rect1.y < rect2.y + rect2.h &&
-                rect1.y + rect1.h > rect2.y);
+        int found = index.topmostAt(x, y, [&](int i) { return isClicked(i, x, y); });
+        return found < 0 ? INVALID_OBJECT : handleAt(found);
     }
 
-    void setRandomPositions()
+    // Visible objects overlapping the camera rect, in draw order. Small
+    // scenes are filtered with one branch-free pass over the arrays; past
+    // LINEAR_SCAN_LIMIT objects the grid index is cheaper.
+    void visibleIn(const SDL_Rect &camera, vector<int> &indices)
     {
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_int_distribution<int> xDistribution(leftSection.x, leftSection.x + leftSection.w - 100); 
-        uniform_int_distribution<int> yDistribution(leftSection.y, leftSection.y + leftSection.h - 100); 
-
-        const char **imagePathPtr = imagePaths;
+        if (size() > LINEAR_SCAN_LIMIT)
+        {
+            index.visibleIn(camera, indices);
+            return;
+        }
 
-        GameObjectNode *current = head;
-        while (current != nullptr)
+        int n = size();
+        overlapFlags.resize(n);
+        const int *x = xs.data();
+        const int *y = ys.data();
+        const int *w = widths.data();
+        const int *h = heights.data();
+        unsigned char *flags = overlapFlags.data();
+        int left = camera.x, top = camera.y, right = camera.x + camera.w, bottom = camera.y + camera.h;
+        for (int i = 0; i < n; ++i)
         {
-            bool overlap = true;
-            int locX, locY;
+            flags[i] = (unsigned char)((x[i] < right) & (x[i] + w[i] > left) & (y[i] < bottom) & (y[i] + h[i] > top));
+        }
 
-            while (overlap)
+        indices.clear();
+        for (int word = 0; word < (int)hiddenBits.size(); ++word)
+        {
+            int base = word * 64;
+            int count = min(64, n - base);
+            uint64_t visible = 0;
+            for (int bit = 0; bit < count; ++bit)
             {
-                overlap = false;
-
-                GameObjectNode *checkNode = head;
-                while (checkNode != current && !overlap)
-                {
-                    if (!checkNode->isHidden() &&
-                        isOverlap({current->x, current->y, current->width, current->height},
-                                  {checkNode->x, checkNode->y, checkNode->width, checkNode->height}))
-                    {
-                        overlap = true;
-                    }
-                    checkNode = checkNode->next;
-                }
-
-                if (!overlap)
-                {
-                    locX = xDistribution(gen);
-                    locY = yDistribution(gen);
-
-                    if (*imagePathPtr)
-                    {
-                        imageCoordinateMap[{locX, locY}] = "images/" + string(*imagePathPtr);
-                        ++imagePathPtr;
-                    }
-                }
+                visible |= (uint64_t)flags[base + bit] << bit;
+            }
+            visible &= ~hiddenBits[word];
+            while (visible != 0)
+            {
+                indices.push_back(base + __builtin_ctzll(visible));
+                visible &= visible - 1;
             }
-
-            current->x = locX;
-            current->y = locY;
-
-            current = current->next;
         }
     }
-    bool handleMouseClick(int mouseX, int mouseY)
+
+    void setRandomPositions(const SDL_Rect &area, int spacing)
     {
-        GameObjectNode *current = head;
+        random_device rd;
+        mt19937 gen(rd());
 
-        while (current != nullptr)
+        PoissonPlacer placer(area, spacing);
+        vector<Placement> items;
+        vector<int> movable;
+        for (int i = 0; i < size(); ++i)
         {
-            if (!current->isHidden() && current->isClicked(mouseX, mouseY))
+            if (pinned[i])
             {
-                auto it = imageCoordinateMap.find({current->x, current->y});
+                placer.addForbidden(rectOf(i));
+            }
+            else
+            {
+                items.push_back({widths[i], heights[i], 0, 0, false});
+                movable.push_back(i);
+            }
+        }
+        placer.place(items, gen);
 
-                if (it != imageCoordinateMap.end())
-                {
-                    if (!imagePathQueue.empty())
-                    {
-                        string imagePath = imagePathQueue.front();
-
-                        if (it->second == imagePath)
-                        {
-                            current->hide();
-
-                            
-                            imagePathQueue.dequeue();
-
-                           
-                            static int correctCount = 0;
-                            if (++correctCount >= 5)
-                            {
-                               
-                                imagePathQueue.clear();
-
-                                correctCount = 0; 
-                            }
-
-                            return true;
-                        }
-                        else
-                        {
-                            
-                            cout << "Incorrect image path clicked." << endl;
-                        }
-                    }
-                    else
-                    {
-                        
-                        cout << "Image path queue is empty." << endl;
-                    }
-                }
-                else
-                {
-                    
-                    cout << "Image not found at coordinates (" << current->x << ", " << current->y << ")." << endl;
-                }
+        for (size_t k = 0; k < items.size(); ++k)
+        {
+            int i = movable[k];
+            if (!items[k].placed)
+            {
+                cout << "No room left for object " << i << "; it stays hidden." << endl;
+                hiddenBits[i >> 6] |= (uint64_t)1 << (i & 63);
+                continue;
             }
-            current = current->next;
+            xs[i] = items[k].x;
+            ys[i] = items[k].y;
         }
+        rebuildIndex();
+    }
 
+    bool handleMouseClick(int mouseX, int mouseY)
+    {
+        ObjectHandle clicked = topmostAt(mouseX, mouseY);
+        if (clicked == INVALID_OBJECT)
+        {
+            return false;
+        }
+
+        if (allObjectsFound())
+        {
+            cout << "All objects have already been found." << endl;
+        }
+        else if (objectIdOf(clicked) == expectedOrder[nextExpected])
+        {
+            hide(clicked);
+            ++nextExpected;
+            return true;
+        }
+        else
+        {
+            cout << "Incorrect object clicked." << endl;
+        }
         return false;
     }
 
-public:
-    GameObjectNode *head = nullptr;
+private:
+    static const int LINEAR_SCAN_LIMIT = 1024;
+
+    vector<int> xs, ys, widths, heights;
+    vector<int> objectIds, spriteIds;
+    vector<unsigned char> pinned;
+    vector<uint64_t> hiddenBits;
+    vector<SDL_Texture *> textures;
+    vector<SDL_Rect> sources;
+    vector<HitMask> masks;
+    vector<unsigned char> overlapFlags;
+    SceneIndex index;
+    int generation;
 };
 
 GameObjectList objects;
@@ -340,6 +400,7 @@ bool init()
         cout << "SDL_ttf initialization failed: " << TTF_GetError() << endl;
         return false;
     }
+    objTtfStarted = true;
 
     gFont = TTF_OpenFont("Boxtoon.ttf", 25);
 
@@ -348,6 +409,7 @@ bool init()
         cout << "Failed to load font: " << TTF_GetError() << endl;
         return false;
     }
+    titleGlyphs.init(objRenderer, gFont);
 
     return true;
 }
@@ -398,11 +460,49 @@ bool loadMedia()
         cout << "Failed to create end texture: " << SDL_GetError() << endl;
         return false;
     }
-    objects.addNode(new GameObjectNode(SDL_CreateTextureFromSurface(objRenderer, IMG_Load("images/knife.png")), 30, 50));
-    objects.addNode(new GameObjectNode(SDL_CreateTextureFromSurface(objRenderer, IMG_Load("images/letter.png")), 50, 50));
-    objects.addNode(new GameObjectNode(SDL_CreateTextureFromSurface(objRenderer, IMG_Load("images/palm.png")), 30, 30));
-    objects.addNode(new GameObjectNode(SDL_CreateTextureFromSurface(objRenderer, IMG_Load("images/syringe.png")), 30, 30));
-    objects.addNode(new GameObjectNode(SDL_CreateTextureFromSurface(objRenderer, IMG_Load("images/key.png")), 30, 30));
+    if (!levelPack.open("textFiles/levels.bin") || !levelPack.getLevel(0, currentLevel))
+    {
+        cout << "Failed to load hidden-object level" << endl;
+        return false;
+    }
+
+    // Objects sharing an image share one sprite. Images packed into the atlas
+    // come from it; anything else is loaded on its own.
+    objectAtlas.load(objRenderer, "images/atlas_objects.txt", "textFiles/atlas_objects.txt");
+    vector<string_view> spriteImages;
+    for (int id = 0; id < currentLevel.objectCount; ++id)
+    {
+        LevelObject object = levelPack.object(currentLevel, id);
+        int sprite = (int)(find(spriteImages.begin(), spriteImages.end(), object.image) - spriteImages.begin());
+        if (sprite == (int)spriteImages.size())
+        {
+            string image(object.image);
+            int atlasSprite = objectAtlas.find(atlasSpriteName(image));
+            if (atlasSprite >= 0)
+            {
+                sprite = objects.addSprite(objectAtlas, atlasSprite);
+            }
+            else
+            {
+                SDL_Surface *objectSurface = IMG_Load(image.c_str());
+                if (objectSurface == nullptr)
+                {
+                    cout << "Failed to load " << image << ": " << IMG_GetError() << endl;
+                    return false;
+                }
+                SDL_Texture *objectTexture = SDL_CreateTextureFromSurface(objRenderer, objectSurface);
+                sprite = objects.addSprite(objectTexture, objectSurface);
+                SDL_FreeSurface(objectSurface);
+            }
+            spriteImages.push_back(object.image);
+        }
+        ObjectHandle handle = objects.add(id, sprite, object.width, object.height);
+        if (object.fixed)
+        {
+            objects.pin(handle, object.x, object.y);
+        }
+    }
+    objectAtlas.releasePixels();
     return true;
 }
 
@@ -472,18 +572,19 @@ class RenderGame
 public:
     RenderGame(GameObjectList &gameObjectList) : gameObjectList(gameObjectList), gameCompleted(false)
     {
-        names = new string[7];
-        names[0] = "FOLLOW THE ORDER";
-        names[1] = "1.Key";
-        names[2] = "2.Syringe";
-        names[3] = "3.Palm Print";
-        names[4] = "4.Sealed letter";
-        names[5] = "5.Knife";
-        names[6] = "NEXT GAME";
     }
-    ~RenderGame()
+
+    // The title, then the objects numbered in the order they must be found.
+    void setLevel(const LevelPack &pack, const Level &level)
     {
-        delete[] names;
+        names.clear();
+        names.push_back(string(level.title));
+        for (int i = 0; i < level.orderCount; ++i)
+        {
+            names.push_back(to_string(i + 1) + "." + string(pack.object(level, level.order[i]).name));
+        }
+        names.push_back("NEXT GAME");
+        layoutText(titleGlyphs, names[0], rightSection.w - 10, titleLayout);
     }
 
     void setGameCompleted(bool completed)
@@ -493,22 +594,22 @@ public:
 
     void renderObjects()
     {
-        SDL_RenderCopy(objRenderer, backgroundTexture1, nullptr, &leftSection);
-        SDL_RenderCopy(objRenderer, backgroundTexture2, nullptr, &rightSection);
+        batch.begin(objRenderer);
+        batch.draw(backgroundTexture1, nullptr, leftSection);
+        batch.draw(backgroundTexture2, nullptr, rightSection);
 
-        GameObjectNode *current = gameObjectList.head;
-        while (current != nullptr)
+        gameObjectList.visibleIn(leftSection, visibleObjects);
+        for (int i : visibleObjects)
         {
-            if (!current->isHidden())
+            SDL_Rect rect = gameObjectList.rectOf(i);
+            if (rect.x >= leftSection.x && rect.x + rect.w <= leftSection.x + leftSection.w &&
+                rect.y >= leftSection.y && rect.y + rect.h <= leftSection.y + leftSection.h)
             {
-                if (current->x >= leftSection.x && current->x + current->width <= leftSection.x + leftSection.w &&
-                    current->y >= leftSection.y && current->y + current->height <= leftSection.y + leftSection.h)
-                {
-                    current->render();
-                }
+                gameObjectList.render(i, batch);
             }
-            current = current->next;
         }
+        batch.end();
+        batch.report("Hidden objects");
     }
 
     void renderNames()
@@ -516,11 +617,11 @@ public:
         int m;
         int n = 50;
 
-        for (int i = 0; i < 7; ++i)
+        for (int i = 0; i < (int)names.size(); ++i)
         {
             if (i == 0)
             {
-                wrapText(names[i], m = 605, n, true);
+                drawLayout(titleGlyphs, names[i], titleLayout, m = 605, n, {255, 255, 255, 255});
                 n = 100;
             }
             else
@@ -540,22 +641,44 @@ public:
 
 public:
     GameObjectList &gameObjectList;
-    string *names;
+    vector<int> visibleObjects;
+    SpriteBatch batch;
+    vector<string> names;
+    TextLayout titleLayout;
     bool gameCompleted;
 };
 
 RenderGame game(objects);
 bool gameWon=false;
+// Also reached from the failure paths before the game runs, so it only
+// releases what is still held and drops this scene's SDL_ttf reference once.
 void close()
 {
+    objectAtlas.free();
+    titleGlyphs.free();
     objects.clear();
-    TTF_CloseFont(gFont);
-    SDL_DestroyRenderer(objRenderer);
-    SDL_DestroyWindow(objWindow);
+    if (gFont != nullptr)
+    {
+        TTF_CloseFont(gFont);
+        gFont = nullptr;
+    }
+    if (objRenderer != nullptr)
+    {
+        SDL_DestroyRenderer(objRenderer);
+        objRenderer = nullptr;
+    }
+    if (objWindow != nullptr)
+    {
+        SDL_DestroyWindow(objWindow);
+        objWindow = nullptr;
+    }
 
     IMG_Quit();
-    TTF_Quit();
-    
+    if (objTtfStarted)
+    {
+        TTF_Quit();
+        objTtfStarted = false;
+    }
 }
 void renderInstruction()
 {
@@ -602,8 +725,9 @@ string runObjectFinding()
     }
 
     renderInstruction();
-    initializeImagePathQueue();
-    objects.setRandomPositions();
+    initializeExpectedOrder();
+    game.setLevel(levelPack, currentLevel);
+    objects.setRandomPositions(currentLevel.area, currentLevel.spacing);
 
     SDL_Event e;
     bool quit = false;
@@ -634,7 +758,7 @@ string runObjectFinding()
 
         SDL_RenderClear(objRenderer);
 
-        if (!game.gameCompleted && imagePathQueue.QueueSize() == 0)
+        if (!game.gameCompleted && allObjectsFound())
         {
             game.setGameCompleted(true);
         }
@@ -651,8 +775,12 @@ string runObjectFinding()
         SDL_RenderPresent(objRenderer);
         SDL_Delay(1000);
     }
-    SDL_DestroyWindow(objWindow);
+    objectAtlas.free();
+    titleGlyphs.free();
     SDL_DestroyRenderer(objRenderer);
+    objRenderer = nullptr;
+    SDL_DestroyWindow(objWindow);
+    objWindow = nullptr;
     string pass;
     PotionMixingGame pGame;
     pass = pGame.run();
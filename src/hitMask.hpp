@@ -0,0 +1,162 @@
+#ifndef HITMASK_HPP
+#define HITMASK_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <SDL2/SDL.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+// Pixels at least this opaque count as part of the sprite.
+const unsigned char HIT_ALPHA_THRESHOLD = 64;
+
+// Row kernels: set bit i of bits[] for every RGBA32 pixel i (bytes R, G, B, A)
+// whose alpha is >= threshold. bits[] must be zeroed by the caller. The plain
+// version is kept public so the benchmark can compare it with the SSE2 path.
+void buildMaskRowScalar(const unsigned char *rgba, int count, unsigned char threshold, uint64_t *bits)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (rgba[4 * i + 3] >= threshold)
+        {
+            bits[i >> 6] |= (uint64_t)1 << (i & 63);
+        }
+    }
+}
+
+void buildMaskRow(const unsigned char *rgba, int count, unsigned char threshold, uint64_t *bits)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    // 16 pixels per step: move each alpha byte to the bottom of its lane,
+    // narrow 32 -> 16 -> 8 bits, compare unsigned via max and collect the
+    // 16 results with movemask. A step never straddles a 64-bit word.
+    const __m128i limit = _mm_set1_epi8((char)threshold);
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i *p = (const __m128i *)(rgba + 4 * i);
+        __m128i a0 = _mm_srli_epi32(_mm_loadu_si128(p), 24);
+        __m128i a1 = _mm_srli_epi32(_mm_loadu_si128(p + 1), 24);
+        __m128i a2 = _mm_srli_epi32(_mm_loadu_si128(p + 2), 24);
+        __m128i a3 = _mm_srli_epi32(_mm_loadu_si128(p + 3), 24);
+        __m128i alpha = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+        __m128i solid = _mm_cmpeq_epi8(_mm_max_epu8(alpha, limit), alpha);
+        uint64_t mask = (uint32_t)_mm_movemask_epi8(solid);
+        bits[i >> 6] |= mask << (i & 63);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        if (rgba[4 * i + 3] >= threshold)
+        {
+            bits[i >> 6] |= (uint64_t)1 << (i & 63);
+        }
+    }
+}
+
+// 1-bit alpha mask of a sprite, one bit per texel, rows padded to 64 bits.
+// Built once when the sprite is loaded so a click that passes the bounding
+// box test is confirmed with a single bit lookup.
+class HitMask
+{
+public:
+    HitMask();
+    bool build(SDL_Surface *surface, unsigned char threshold = HIT_ALPHA_THRESHOLD);
+    void buildFromRGBA(const unsigned char *pixels, int width, int height, int pitch,
+                       unsigned char threshold = HIT_ALPHA_THRESHOLD);
+    bool test(int x, int y) const;
+    bool hitScaled(int localX, int localY, int drawWidth, int drawHeight) const;
+    bool isEmpty() const;
+    int getWidth() const;
+    int getHeight() const;
+    const vector<uint64_t> &getBits() const;
+
+private:
+    int mWidth, mHeight, mWordsPerRow;
+    vector<uint64_t> mBits;
+};
+
+HitMask::HitMask()
+{
+    mWidth = 0;
+    mHeight = 0;
+    mWordsPerRow = 0;
+}
+
+bool HitMask::build(SDL_Surface *surface, unsigned char threshold)
+{
+    mBits.clear();
+    mWidth = mHeight = mWordsPerRow = 0;
+    SDL_Surface *rgba = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    if (rgba == NULL)
+    {
+        cout << "Unable to build hit mask! SDL Error: " << SDL_GetError() << endl;
+        return false;
+    }
+    SDL_LockSurface(rgba);
+    buildFromRGBA((const unsigned char *)rgba->pixels, rgba->w, rgba->h, rgba->pitch, threshold);
+    SDL_UnlockSurface(rgba);
+    SDL_FreeSurface(rgba);
+    return true;
+}
+
+void HitMask::buildFromRGBA(const unsigned char *pixels, int width, int height, int pitch, unsigned char threshold)
+{
+    mWidth = width;
+    mHeight = height;
+    mWordsPerRow = (width + 63) / 64;
+    mBits.assign((size_t)mWordsPerRow * height, 0);
+    for (int y = 0; y < height; ++y)
+    {
+        buildMaskRow(pixels + (size_t)y * pitch, width, threshold, &mBits[(size_t)y * mWordsPerRow]);
+    }
+}
+
+bool HitMask::test(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+    {
+        return false;
+    }
+    return (mBits[(size_t)y * mWordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+}
+
+// Tests a point given relative to a sprite drawn at drawWidth x drawHeight.
+// Bounding-box edges are inclusive like the rect checks, so the far edge maps
+// onto the last texel. An empty mask (sprite not loaded) accepts the point.
+bool HitMask::hitScaled(int localX, int localY, int drawWidth, int drawHeight) const
+{
+    if (isEmpty() || drawWidth <= 0 || drawHeight <= 0)
+    {
+        return true;
+    }
+    int x = (int)((int64_t)localX * mWidth / drawWidth);
+    int y = (int)((int64_t)localY * mHeight / drawHeight);
+    return test(min(x, mWidth - 1), min(y, mHeight - 1));
+}
+
+bool HitMask::isEmpty() const
+{
+    return mBits.empty();
+}
+
+int HitMask::getWidth() const
+{
+    return mWidth;
+}
+
+int HitMask::getHeight() const
+{
+    return mHeight;
+}
+
+const vector<uint64_t> &HitMask::getBits() const
+{
+    return mBits;
+}
+
+#endif
@@ -1,53 +1,294 @@
+#ifndef IMAGEVIEWER_HPP
+#define IMAGEVIEWER_HPP
+
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 
 using namespace std;
 
+// A carousel node only knows its path until the image is needed. The decode
+// thread turns queued paths into surfaces; textures are made on the main
+// thread (the renderer is not thread-safe) by update() or when an image is
+// shown before its prefetch finished.
+enum ImageState {
+    IMAGE_UNLOADED,
+    IMAGE_QUEUED,
+    IMAGE_DECODING,
+    IMAGE_DECODED,
+    IMAGE_RESIDENT,
+    IMAGE_FAILED
+};
 
 struct ImageNode {
     string imageName;
     SDL_Texture* texture;
+    // state and decoded are shared with the decode thread, under queueMutex.
+    ImageState state;
+    SDL_Surface* decoded;
+    Uint64 lastUsed;
     ImageNode* next;
     ImageNode* prev;
 
-    ImageNode(const string& name, SDL_Texture* tex) : imageName(name), texture(tex), next(nullptr), prev(nullptr) {}
+    ImageNode(const string& name) : imageName(name), texture(nullptr), state(IMAGE_UNLOADED), decoded(nullptr), lastUsed(0), next(nullptr), prev(nullptr) {}
 };
 
 
 const int IMAGE_WIDTH = 200;
 const int IMAGE_HEIGHT = 150;
+// The current image and both neighbours; anything older is dropped first.
+const int MAX_RESIDENT_IMAGES = 3;
+const Uint32 DEFAULT_TRANSITION_MS = 250;
+
+// How the carousel moves between images. Both images stay resident for the
+// whole transition; each frame only changes alpha or destination offsets.
+enum TransitionStyle {
+    TRANSITION_NONE,
+    TRANSITION_CROSSFADE,
+    TRANSITION_SLIDE
+};
 
 
 class ImageViewer {
 private:
     ImageNode* current;
     SDL_Renderer* renderer;
+    int residentCount;
+    Uint64 useClock;
 
-public:
-    ImageViewer(SDL_Renderer* rend) : current(nullptr), renderer(rend) {}
+    TransitionStyle transitionStyle;
+    Uint32 transitionMs;
+    ImageNode* transitionFrom;
+    Uint32 transitionStart;
+    int transitionDirection;
 
+    thread decoder;
+    mutex queueMutex;
+    condition_variable queueReady;
+    condition_variable decodeDone;
+    deque<ImageNode*> pending;
+    vector<ImageNode*> finished;
+    bool stopping;
 
-    void addImage(const string& imageName) {
+    // Decoded straight to the renderer's native layout so the upload on the
+    // main thread is a plain copy.
+    static SDL_Surface* decodeImage(const string& imageName) {
         SDL_Surface* surface = IMG_Load(imageName.c_str());
         if (!surface) {
             cerr << "Failed to load image: " << IMG_GetError() << endl;
+            return nullptr;
+        }
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surface);
+        return converted;
+    }
+
+    void decodeLoop() {
+        unique_lock<mutex> lock(queueMutex);
+        while (true) {
+            queueReady.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (stopping) {
+                return;
+            }
+            ImageNode* node = pending.front();
+            pending.pop_front();
+            node->state = IMAGE_DECODING;
+            lock.unlock();
+            SDL_Surface* surface = decodeImage(node->imageName);
+            lock.lock();
+            node->decoded = surface;
+            node->state = surface ? IMAGE_DECODED : IMAGE_FAILED;
+            finished.push_back(node);
+            decodeDone.notify_all();
+        }
+    }
+
+    void prefetch(ImageNode* node) {
+        lock_guard<mutex> lock(queueMutex);
+        if (node->state != IMAGE_UNLOADED) {
             return;
         }
+        node->state = IMAGE_QUEUED;
+        pending.push_back(node);
+        if (!decoder.joinable()) {
+            decoder = thread(&ImageViewer::decodeLoop, this);
+        }
+        queueReady.notify_one();
+    }
+
+    bool isNeighbourhood(const ImageNode* node) const {
+        return node == current || node == current->next || node == current->prev || node == transitionFrom;
+    }
 
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    void startTransition(ImageNode* from, int direction) {
+        transitionFrom = from;
+        transitionStart = SDL_GetTicks();
+        transitionDirection = direction;
+    }
+
+    // Eased progress of the running transition, 1 once it is over.
+    float transitionProgress(Uint32 now) const {
+        if (transitionStyle == TRANSITION_NONE || transitionMs == 0 || now - transitionStart >= transitionMs) {
+            return 1.0f;
+        }
+        float t = (float)(now - transitionStart) / transitionMs;
+        return t * t * (3.0f - 2.0f * t);
+    }
+
+    void drawTransition(float t) {
+        SDL_Texture* from = transitionFrom->texture;
+        SDL_Texture* to = current->texture;
+        if (transitionStyle == TRANSITION_SLIDE) {
+            int w, h;
+            SDL_GetRendererOutputSize(renderer, &w, &h);
+            int offset = (int)(t * w) * transitionDirection;
+            SDL_Rect fromRect = {-offset, 0, w, h};
+            SDL_Rect toRect = {transitionDirection * w - offset, 0, w, h};
+            if (from) {
+                SDL_RenderCopy(renderer, from, nullptr, &fromRect);
+            }
+            if (to) {
+                SDL_RenderCopy(renderer, to, nullptr, &toRect);
+            }
+            return;
+        }
+        // Crossfade: the old image stays opaque underneath while the new one
+        // fades in over it.
+        if (from) {
+            SDL_RenderCopy(renderer, from, nullptr, nullptr);
+        }
+        if (to) {
+            SDL_SetTextureBlendMode(to, SDL_BLENDMODE_BLEND);
+            SDL_SetTextureAlphaMod(to, (Uint8)(t * 255));
+            SDL_RenderCopy(renderer, to, nullptr, nullptr);
+            SDL_SetTextureAlphaMod(to, 255);
+        }
+    }
+
+    // Called with the surface already taken out of the shared state.
+    void upload(ImageNode* node, SDL_Surface* surface) {
+        node->texture = SDL_CreateTextureFromSurface(renderer, surface);
         SDL_FreeSurface(surface);
+        lock_guard<mutex> lock(queueMutex);
+        node->state = node->texture ? IMAGE_RESIDENT : IMAGE_FAILED;
+        if (node->texture) {
+            node->lastUsed = ++useClock;
+            ++residentCount;
+        }
+    }
+
+    void evict() {
+        while (residentCount > MAX_RESIDENT_IMAGES) {
+            ImageNode* oldest = nullptr;
+            ImageNode* node = current;
+            do {
+                if (node->texture && !isNeighbourhood(node) && (!oldest || node->lastUsed < oldest->lastUsed)) {
+                    oldest = node;
+                }
+                node = node->next;
+            } while (node != current);
+            if (!oldest) {
+                return;
+            }
+            SDL_DestroyTexture(oldest->texture);
+            oldest->texture = nullptr;
+            --residentCount;
+            lock_guard<mutex> lock(queueMutex);
+            oldest->state = IMAGE_UNLOADED;
+        }
+    }
+
+    // The image on screen cannot wait for the queue: it is taken off the
+    // queue and decoded here, or waited for if the thread already has it.
+    bool makeResident(ImageNode* node) {
+        if (node->texture) {
+            node->lastUsed = ++useClock;
+            return true;
+        }
+        SDL_Surface* surface = nullptr;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            decodeDone.wait(lock, [node] { return node->state != IMAGE_DECODING; });
+            if (node->state == IMAGE_FAILED) {
+                return false;
+            }
+            if (node->state == IMAGE_QUEUED) {
+                for (auto it = pending.begin(); it != pending.end(); ++it) {
+                    if (*it == node) {
+                        pending.erase(it);
+                        break;
+                    }
+                }
+            }
+            surface = node->decoded;
+            node->decoded = nullptr;
+            node->state = IMAGE_DECODING;
+        }
+        if (!surface) {
+            surface = decodeImage(node->imageName);
+        }
+        if (!surface) {
+            lock_guard<mutex> lock(queueMutex);
+            node->state = IMAGE_FAILED;
+            return false;
+        }
+        upload(node, surface);
+        return node->texture != nullptr;
+    }
+
+public:
+    ImageViewer(SDL_Renderer* rend) : current(nullptr), renderer(rend), residentCount(0), useClock(0), transitionStyle(TRANSITION_CROSSFADE),
+                                      transitionMs(DEFAULT_TRANSITION_MS), transitionFrom(nullptr), transitionStart(0), transitionDirection(1), stopping(false) {}
+
+    ImageViewer(const ImageViewer&) = delete;
+    ImageViewer& operator=(const ImageViewer&) = delete;
 
-        ImageNode* newNode = new ImageNode(imageName, texture);
+    ~ImageViewer() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_one();
+        if (decoder.joinable()) {
+            decoder.join();
+        }
+        if (!current) {
+            return;
+        }
+        ImageNode* node = current->next;
+        while (true) {
+            ImageNode* next = node->next;
+            SDL_FreeSurface(node->decoded);
+            if (node->texture) {
+                SDL_DestroyTexture(node->texture);
+            }
+            bool last = node == current;
+            delete node;
+            if (last) {
+                break;
+            }
+            node = next;
+        }
+    }
+
+    // Only records the path; nothing is read from disk until the image is
+    // shown or becomes a neighbour of the one shown.
+    void addImage(const string& imageName) {
+        ImageNode* newNode = new ImageNode(imageName);
 
         if (!current) {
-          
+
             newNode->next = newNode;
             newNode->prev = newNode;
             current = newNode;
         } else {
-           
+
             newNode->next = current->next;
             current->next->prev = newNode;
             newNode->prev = current;
@@ -55,27 +296,84 @@ public:
         }
     }
 
+    // Uploads whatever the decode thread finished since the last call. Cheap
+    // when there is nothing to do, so it can run every pass of an event loop.
+    void update() {
+        vector<pair<ImageNode*, SDL_Surface*>> ready;
+        {
+            lock_guard<mutex> lock(queueMutex);
+            for (ImageNode* node : finished) {
+                if (node->state == IMAGE_DECODED) {
+                    ready.push_back({node, node->decoded});
+                    node->decoded = nullptr;
+                    node->state = IMAGE_DECODING;
+                }
+            }
+            finished.clear();
+        }
+        for (auto& item : ready) {
+            if (current && isNeighbourhood(item.first)) {
+                upload(item.first, item.second);
+            } else {
+                // Scrolled past before it arrived.
+                SDL_FreeSurface(item.second);
+                lock_guard<mutex> lock(queueMutex);
+                item.first->state = IMAGE_UNLOADED;
+            }
+        }
+        if (current) {
+            evict();
+        }
+    }
+
+    void setTransition(TransitionStyle style, Uint32 durationMs) {
+        transitionStyle = style;
+        transitionMs = durationMs;
+    }
 
-    void displayCurrentImage() const {
+    // True until the frame that finishes the last move has been drawn; keep
+    // calling displayCurrentImage() every frame while it is.
+    bool isAnimating() const {
+        return transitionFrom != nullptr;
+    }
+
+    // Draws one frame at the frame clock's current point of the transition,
+    // or just the current image when there is none. Never waits on the clock.
+    void displayCurrentImage() {
         if (current) {
-          
+            update();
+            bool shown = makeResident(current);
+            float t = transitionFrom ? transitionProgress(SDL_GetTicks()) : 1.0f;
+
             SDL_RenderClear(renderer);
 
-           
-            SDL_RenderCopy(renderer, current->texture, nullptr, nullptr);
+            if (t < 1.0f) {
+                drawTransition(t);
+            } else if (shown) {
+                SDL_RenderCopy(renderer, current->texture, nullptr, nullptr);
+            }
 
-       
             SDL_RenderPresent(renderer);
+
+            if (t >= 1.0f) {
+                transitionFrom = nullptr;
+            }
+            prefetch(current->next);
+            prefetch(current->prev);
+            evict();
         } else {
             cout << "No images in the viewer." << endl;
         }
     }
-    
 
-   
+
+
+    // A move during a transition starts the next one from the image that
+    // was coming in, so repeated key presses are never queued up.
     void nextImage() {
         if (current) {
-           
+
+            startTransition(current, 1);
             current = current->next;
         } else {
             cout << "No images in the viewer." << endl;
@@ -84,7 +382,8 @@ public:
 
     void prevImage() {
         if (current) {
-          
+
+            startTransition(current, -1);
             current = current->prev;
         } else {
             cout << "No images in the viewer." << endl;
@@ -92,3 +391,4 @@ public:
     }
 };
 
+#endif
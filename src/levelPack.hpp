@@ -0,0 +1,241 @@
+#ifndef LEVELPACK_HPP
+#define LEVELPACK_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <SDL2/SDL_rect.h>
+#include "mappedFile.hpp"
+using namespace std;
+
+// Hidden-object levels compiled by tools/levelCompiler from the text form in
+// textFiles/levels.txt. Binary layout (little-endian):
+//   LevelPackHeader
+//   LevelRecord[levelCount]         at levelOffset
+//   LevelObjectRecord[objectCount]  at objectOffset
+//   uint16_t order[orderCount]      at orderOffset (indices into the level)
+//   text blob of textSize bytes     at textOffset
+// Everything is validated once in open(), after which levels are read
+// straight from the mapping.
+enum LevelPlacement
+{
+    PLACE_RANDOM = 0,
+    PLACE_FIXED = 1
+};
+
+struct LevelPackHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t levelCount;
+    uint32_t levelOffset;
+    uint32_t objectCount;
+    uint32_t objectOffset;
+    uint32_t orderCount;
+    uint32_t orderOffset;
+    uint32_t textOffset;
+    uint32_t textSize;
+};
+
+struct LevelRecord
+{
+    uint32_t titleOffset;
+    uint16_t titleLength;
+    uint16_t spacing;
+    int16_t areaX, areaY;
+    uint16_t areaW, areaH;
+    uint32_t firstObject;
+    uint16_t objectCount;
+    uint16_t orderCount;
+    uint32_t firstOrder;
+};
+
+struct LevelObjectRecord
+{
+    uint32_t imageOffset;
+    uint32_t nameOffset;
+    uint16_t imageLength;
+    uint16_t nameLength;
+    int16_t x, y;
+    uint16_t width, height;
+    uint8_t placement;
+    uint8_t reserved[3];
+};
+
+const char LEVEL_PACK_MAGIC[4] = {'E', 'R', 'L', 'V'};
+const uint32_t LEVEL_PACK_VERSION = 1;
+
+// The scene's play field, left of the list of names. Objects are indexed,
+// clipped and drawn against it, so the compiler only accepts level areas
+// that lie inside it.
+const SDL_Rect LEVEL_SCENE_AREA = {0, 0, 600, 600};
+
+struct LevelObject
+{
+    string_view image;
+    string_view name;
+    int x, y, width, height;
+    bool fixed;
+};
+
+struct Level
+{
+    string_view title;
+    SDL_Rect area;
+    int spacing;
+    int objectCount;
+    int orderCount;
+    const LevelObjectRecord *objects;
+    const uint16_t *order;
+};
+
+class LevelPack
+{
+public:
+    LevelPack();
+    bool open(const string &path);
+    size_t size() const;
+    bool getLevel(size_t index, Level &level) const;
+    LevelObject object(const Level &level, int i) const;
+
+private:
+    MappedFile mFile;
+    const LevelRecord *mLevels;
+    const LevelObjectRecord *mObjects;
+    const uint16_t *mOrder;
+    const char *mText;
+    size_t mLevelCount;
+
+    bool validate(const LevelPackHeader &header) const;
+};
+
+LevelPack::LevelPack()
+{
+    mLevels = NULL;
+    mObjects = NULL;
+    mOrder = NULL;
+    mText = NULL;
+    mLevelCount = 0;
+}
+
+bool LevelPack::validate(const LevelPackHeader &header) const
+{
+    uint64_t fileSize = mFile.size();
+    if (header.levelOffset % alignof(LevelRecord) != 0 || header.objectOffset % alignof(LevelObjectRecord) != 0 ||
+        header.orderOffset % alignof(uint16_t) != 0 ||
+        header.levelOffset + (uint64_t)header.levelCount * sizeof(LevelRecord) > fileSize ||
+        header.objectOffset + (uint64_t)header.objectCount * sizeof(LevelObjectRecord) > fileSize ||
+        header.orderOffset + (uint64_t)header.orderCount * sizeof(uint16_t) > fileSize ||
+        (uint64_t)header.textOffset + header.textSize > fileSize)
+    {
+        return false;
+    }
+
+    const LevelRecord *levels = (const LevelRecord *)(mFile.data() + header.levelOffset);
+    const LevelObjectRecord *objects = (const LevelObjectRecord *)(mFile.data() + header.objectOffset);
+    const uint16_t *order = (const uint16_t *)(mFile.data() + header.orderOffset);
+    for (uint32_t i = 0; i < header.levelCount; ++i)
+    {
+        const LevelRecord &level = levels[i];
+        if ((uint64_t)level.titleOffset + level.titleLength > header.textSize ||
+            (uint64_t)level.firstObject + level.objectCount > header.objectCount ||
+            (uint64_t)level.firstOrder + level.orderCount > header.orderCount)
+        {
+            return false;
+        }
+        for (uint32_t j = 0; j < level.orderCount; ++j)
+        {
+            if (order[level.firstOrder + j] >= level.objectCount)
+            {
+                return false;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < header.objectCount; ++i)
+    {
+        const LevelObjectRecord &object = objects[i];
+        if ((uint64_t)object.imageOffset + object.imageLength > header.textSize ||
+            (uint64_t)object.nameOffset + object.nameLength > header.textSize)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LevelPack::open(const string &path)
+{
+    mLevels = NULL;
+    mObjects = NULL;
+    mOrder = NULL;
+    mText = NULL;
+    mLevelCount = 0;
+    if (!mFile.open(path))
+    {
+        return false;
+    }
+
+    LevelPackHeader header;
+    if (mFile.size() < sizeof(header))
+    {
+        cout << "Level pack " << path << " is truncated!" << endl;
+        return false;
+    }
+    memcpy(&header, mFile.data(), sizeof(header));
+    if (memcmp(header.magic, LEVEL_PACK_MAGIC, 4) != 0 || header.version != LEVEL_PACK_VERSION)
+    {
+        cout << "Level pack " << path << " has an unknown format!" << endl;
+        return false;
+    }
+    if (!validate(header))
+    {
+        cout << "Level pack " << path << " is corrupt!" << endl;
+        return false;
+    }
+
+    mLevels = (const LevelRecord *)(mFile.data() + header.levelOffset);
+    mObjects = (const LevelObjectRecord *)(mFile.data() + header.objectOffset);
+    mOrder = (const uint16_t *)(mFile.data() + header.orderOffset);
+    mText = mFile.data() + header.textOffset;
+    mLevelCount = header.levelCount;
+    return true;
+}
+
+size_t LevelPack::size() const
+{
+    return mLevelCount;
+}
+
+bool LevelPack::getLevel(size_t index, Level &level) const
+{
+    if (index >= mLevelCount)
+    {
+        return false;
+    }
+    const LevelRecord &record = mLevels[index];
+    level.title = string_view(mText + record.titleOffset, record.titleLength);
+    level.area = {record.areaX, record.areaY, record.areaW, record.areaH};
+    level.spacing = record.spacing;
+    level.objectCount = record.objectCount;
+    level.orderCount = record.orderCount;
+    level.objects = mObjects + record.firstObject;
+    level.order = mOrder + record.firstOrder;
+    return true;
+}
+
+LevelObject LevelPack::object(const Level &level, int i) const
+{
+    const LevelObjectRecord &record = level.objects[i];
+    LevelObject object;
+    object.image = string_view(mText + record.imageOffset, record.imageLength);
+    object.name = string_view(mText + record.nameOffset, record.nameLength);
+    object.x = record.x;
+    object.y = record.y;
+    object.width = record.width;
+    object.height = record.height;
+    object.fixed = record.placement == PLACE_FIXED;
+    return object;
+}
+
+#endif
@@ -1,23 +1,26 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
 #include <iostream>
 #include "passwordScreen.hpp"
 #include "maze.hpp"
 #include "decoding.hpp"
 #include "riddles.hpp"
 #include "hiddenObjects.hpp"
+#include "widgets.hpp"
 
 using namespace std;
-PassScreen passwordScreen;
 string door2_Pass, door3_Pass, door4_Pass = "Egress";
 class MainScreen
 {
 public:
-    MainScreen() : gWindow(nullptr), gRenderer(nullptr), gBackgroundTexture(nullptr)
+    MainScreen() : pendingDoor(-1), ttfStarted(false), gWindow(nullptr), gRenderer(nullptr), gBackgroundTexture(nullptr), doorWidgets(SCREEN_WIDTH, SCREEN_HEIGHT)
     {
+        const SDL_Rect doorRects[NUM_DOORS] = {{30, 285, 140, 300}, {225, 285, 142, 300}, {420, 285, 145, 300}, {628, 285, 145, 300}};
         for (int i = 0; i < NUM_DOORS; ++i)
         {
             doorStates[i] = DoorState::Unlocked;
+            doorWidgets.add(i, doorRects[i]);
         }
     }
 
@@ -41,7 +44,7 @@ public:
             return false;
         }
 
-        gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED);
+        gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
         if (gRenderer == nullptr)
         {
             cout << "Renderer could not be created! SDL_Error:" << SDL_GetError() << endl;
@@ -56,13 +59,22 @@ public:
             return false;
         }
 
+        // Held for the whole session; the games' own TTF_Init/TTF_Quit pairs
+        // only add and drop references on top of it.
+        if (TTF_Init() == -1)
+        {
+            cout << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << endl;
+            return false;
+        }
+        ttfStarted = true;
+
         gBackgroundTexture = loadTexture("images/mainBg.png");
         if (gBackgroundTexture == nullptr)
         {
             return false;
         }
 
-        return true;
+        return passwordScreen.init(gRenderer, SCREEN_WIDTH, SCREEN_HEIGHT);
     }
     void renderLost()
     {
@@ -80,17 +92,14 @@ public:
 
 
         renderTexture(gBackgroundTexture, 0, 0);
-
-        SDL_Rect door1 = {30, 285, 140, 300};
-        SDL_Rect door2 = {225, 285, 142, 300};
-        SDL_Rect door3 = {420, 285, 145, 300};
-        SDL_Rect door4 = {628, 285, 145, 300};
+        passwordScreen.render();
 
         SDL_RenderPresent(gRenderer);
     }
     void handleMouseClick(int x, int y)
     {
-        if (isPointInsideRect(x, y, 30, 285, 140, 300) && doorStates[0] == DoorState::Unlocked)
+        int door = doorWidgets.hitTest(x, y);
+        if (door == 0 && doorStates[0] == DoorState::Unlocked)
         {
             cout << "Clicked on door 1!\n";
             Decoding Decoding;
@@ -102,11 +111,21 @@ public:
             
             doorStates[0] = DoorState::Locked;
         }
-        else if (isPointInsideRect(x, y, 225, 285, 142, 300) && doorStates[1] == DoorState::Unlocked)
+        else if (door >= 1 && door < NUM_DOORS && doorStates[door] == DoorState::Unlocked)
         {
-            cout << "Clicked on door 2!\n";
-            showPasswordScreen(door2_Pass);
-            if (passwordScreen.isAccessGranted())
+            cout << "Clicked on door " << door + 1 << "!\n";
+            const string passes[NUM_DOORS] = {"", door2_Pass, door3_Pass, door4_Pass};
+            passwordScreen.open(passes[door]);
+            pendingDoor = door;
+        }
+    }
+
+    // Runs once the password overlay for the door has shown its answer.
+    void enterDoor(int door)
+    {
+        if (passwordScreen.isAccessGranted())
+        {
+            if (door == 1)
             {
                 door3_Pass = runObjectFinding();
                 if (!wonLabGame())
@@ -114,14 +133,7 @@ public:
                     renderLost();
                 }
             }
-                doorStates[1] = DoorState::Locked;
-            
-        }
-        else if (isPointInsideRect(x, y, 420, 285, 145, 300) && doorStates[2] == DoorState::Unlocked)
-        {
-            cout << "Clicked on door 3!\n";
-            showPasswordScreen(door3_Pass);
-            if (passwordScreen.isAccessGranted())
+            else if (door == 2)
             {
                 RiddlesGame rGame;
                 rGame.run();
@@ -130,13 +142,7 @@ public:
                     renderLost();
                 }
             }
-            doorStates[2] = DoorState::Locked;
-        }
-        else if (isPointInsideRect(x, y, 628, 285, 145, 300) && doorStates[3] == DoorState::Unlocked)
-        {
-            cout << "Clicked on door 4!\n";
-            showPasswordScreen(door4_Pass);
-            if (passwordScreen.isAccessGranted())
+            else if (door == 3)
             {
                 MazeGame mGame;
                 mGame.run();
@@ -145,13 +151,8 @@ public:
                     renderLost();
                 }
             }
-            doorStates[3] = DoorState::Locked;
         }
-    }
-
-    bool isPointInsideRect(int x, int y, int rectX, int rectY, int rectWidth, int rectHeight)
-    {
-        return (x >= rectX && x <= rectX + rectWidth && y >= rectY && y <= rectY + rectHeight);
+        doorStates[door] = DoorState::Locked;
     }
 
     void run()
@@ -167,6 +168,10 @@ public:
                 {
                     quit = true;
                 }
+                else if (passwordScreen.isActive())
+                {
+                    passwordScreen.handleEvent(e);
+                }
                 else if (e.type == SDL_MOUSEBUTTONDOWN)
                 {
                     int mouseX, mouseY;
@@ -175,15 +180,43 @@ public:
                 }
             }
 
+            passwordScreen.update(SDL_GetTicks());
+            if (pendingDoor >= 0 && !passwordScreen.isActive())
+            {
+                int door = pendingDoor;
+                pendingDoor = -1;
+                enterDoor(door);
+            }
+
             render();
         }
     }
 
+    // renderLost() and the destructor both close, so everything is nulled
+    // and the second call only repeats the harmless *_Quit calls.
     void close()
     {
-        SDL_DestroyTexture(gBackgroundTexture);
-        SDL_DestroyRenderer(gRenderer);
-        SDL_DestroyWindow(gWindow);
+        passwordScreen.free();
+        if (ttfStarted)
+        {
+            TTF_Quit();
+            ttfStarted = false;
+        }
+        if (gBackgroundTexture != nullptr)
+        {
+            SDL_DestroyTexture(gBackgroundTexture);
+            gBackgroundTexture = nullptr;
+        }
+        if (gRenderer != nullptr)
+        {
+            SDL_DestroyRenderer(gRenderer);
+            gRenderer = nullptr;
+        }
+        if (gWindow != nullptr)
+        {
+            SDL_DestroyWindow(gWindow);
+            gWindow = nullptr;
+        }
         IMG_Quit();
         SDL_Quit();
     }
@@ -197,11 +230,15 @@ private:
 
     static const int NUM_DOORS = 4;
     DoorState doorStates[NUM_DOORS];
+    PassScreen passwordScreen;
+    int pendingDoor;
+    bool ttfStarted;
     SDL_Window *gWindow;
     SDL_Renderer *gRenderer;
     SDL_Texture *gBackgroundTexture;
     const int SCREEN_WIDTH = 800;
     const int SCREEN_HEIGHT = 600;
+    WidgetRegistry doorWidgets;
 
     SDL_Texture *loadTexture(const std::string &path)
     {
@@ -230,12 +267,6 @@ private:
         SDL_Rect renderQuad = {x, y, SCREEN_WIDTH, SCREEN_HEIGHT};
         SDL_RenderCopy(gRenderer, texture, NULL, &renderQuad);
     }
-
-    void showPasswordScreen(const string st)
-    {
-        passwordScreen = PassScreen();
-        passwordScreen.run(st);
-    }
 };
 
 int main(int argc, char *args[])
@@ -0,0 +1,163 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <iostream>
+#include <string>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+// Read-only memory mapping of a whole file. Binary content packs are laid
+// out so they can be used straight from the mapping without parsing.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+    bool open(const string &path);
+    void close();
+    const char *data() const;
+    size_t size() const;
+    bool isOpen() const;
+
+private:
+#ifdef _WIN32
+    HANDLE mFile;
+    HANDLE mMapping;
+#else
+    int mFd;
+#endif
+    const char *mData;
+    size_t mSize;
+
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+};
+
+MappedFile::MappedFile()
+{
+#ifdef _WIN32
+    mFile = INVALID_HANDLE_VALUE;
+    mMapping = NULL;
+#else
+    mFd = -1;
+#endif
+    mData = NULL;
+    mSize = 0;
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const string &path)
+{
+    close();
+#ifdef _WIN32
+    mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mFile == INVALID_HANDLE_VALUE)
+    {
+        cout << "Unable to open " << path << " for mapping!" << endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(mFile, &fileSize) || fileSize.QuadPart == 0)
+    {
+        cout << "Unable to map empty file " << path << "!" << endl;
+        close();
+        return false;
+    }
+    mSize = (size_t)fileSize.QuadPart;
+    mMapping = CreateFileMappingA(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mMapping != NULL)
+    {
+        mData = (const char *)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    mFd = ::open(path.c_str(), O_RDONLY);
+    if (mFd < 0)
+    {
+        cout << "Unable to open " << path << " for mapping!" << endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(mFd, &info) != 0 || info.st_size == 0)
+    {
+        cout << "Unable to map empty file " << path << "!" << endl;
+        close();
+        return false;
+    }
+    mSize = (size_t)info.st_size;
+    void *mapped = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, mFd, 0);
+    mData = (mapped == MAP_FAILED) ? NULL : (const char *)mapped;
+#endif
+    if (mData == NULL)
+    {
+        cout << "Unable to map " << path << "!" << endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (mData != NULL)
+    {
+        UnmapViewOfFile(mData);
+    }
+    if (mMapping != NULL)
+    {
+        CloseHandle(mMapping);
+    }
+    if (mFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(mFile);
+    }
+    mFile = INVALID_HANDLE_VALUE;
+    mMapping = NULL;
+#else
+    if (mData != NULL)
+    {
+        munmap((void *)mData, mSize);
+    }
+    if (mFd >= 0)
+    {
+        ::close(mFd);
+    }
+    mFd = -1;
+#endif
+    mData = NULL;
+    mSize = 0;
+}
+
+const char *MappedFile::data() const
+{
+    return mData;
+}
+
+size_t MappedFile::size() const
+{
+    return mSize;
+}
+
+bool MappedFile::isOpen() const
+{
+    return mData != NULL;
+}
+
+#endif
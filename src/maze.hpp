@@ -7,6 +7,8 @@
 #include <chrono>
 #include <thread>
 #include "DSA.hpp"
+#include "spriteBatch.hpp"
+#include "glyphCache.hpp"
 
 using namespace std;
 
@@ -35,12 +37,17 @@ class MazeGame
 private:
     SDL_Window *gWindow;
     SDL_Renderer *gRenderer;
+    bool ttfStarted;
     SDL_Texture *startTexture;
     SDL_Rect startButtonRect;
     SDL_Texture *wonTexture;
     bool Won;
 
     Cell maze[ROWS][COLS];
+    SpriteBatch batch;
+    // Cut from the font's distance field once; the timer text itself is
+    // never rasterized.
+    GlyphCache introGlyphs;
     int playerRow, playerCol;
     bool gameStarted;
 
@@ -106,6 +113,9 @@ private:
         SDL_SetRenderDrawColor(gRenderer, 245, 245, 220, 255);
         SDL_RenderClear(gRenderer);
 
+        // Path cells match the clear colour, so only the others are queued;
+        // the whole maze then goes out as a single geometry call.
+        batch.begin(gRenderer);
         for (int i = 0; i < ROWS; ++i)
         {
             for (int j = 0; j < COLS; ++j)
@@ -114,21 +124,21 @@ private:
                 switch (maze[i][j].state)
                 {
                 case CellState::WALL:
-                    SDL_SetRenderDrawColor(gRenderer, 139, 69, 19, 255);
+                    batch.fillRect(rect, {139, 69, 19, 255});
                     break;
                 case CellState::PATH:
-                    SDL_SetRenderDrawColor(gRenderer, 245, 245, 220, 255);
                     break;
                 case CellState::START:
-                    SDL_SetRenderDrawColor(gRenderer, 0, 70, 0, 255); 
+                    batch.fillRect(rect, {0, 70, 0, 255});
                     break;
                 case CellState::END:
-                    SDL_SetRenderDrawColor(gRenderer, 119, 0, 0, 255);
+                    batch.fillRect(rect, {119, 0, 0, 255});
                     break;
                 }
-                SDL_RenderFillRect(gRenderer, &rect);
             }
         }
+        batch.end();
+        batch.report("Maze");
 
         SDL_RenderPresent(gRenderer);
     }
@@ -215,50 +225,12 @@ private:
     {
         SDL_SetRenderDrawColor(gRenderer, 159, 89, 39, 255);
         SDL_RenderClear(gRenderer);
-        SDL_Color textColor = {245, 245, 220};
-        SDL_Surface *textSurface = nullptr;
-        SDL_Texture *textTexture = nullptr;
-
-        SDL_Rect textRect;
-        textRect.x = sc_Width / 4;
-        textRect.y = sc_Height / 4;
-        textRect.w = sc_Width / 2;
-        textRect.h = sc_Height / 2;
-
-        SDL_RenderPresent(gRenderer);
-
-        TTF_Font *font = TTF_OpenFont("JosefinSans-Bold.ttf", 100);
-        if (font == nullptr)
-        {
-            cout << "Failed to load font! SDL_ttf Error: " << TTF_GetError() << endl;
-            return;
-        }
 
         string timerText = "Time: " + to_string(gameDurationInSeconds) + " sec";
-
-        textSurface = TTF_RenderText_Blended(font, timerText.c_str(), textColor);
-
-        if (textSurface == nullptr)
-        {
-            cout << "Unable to render text surface! SDL_ttf Error: " << TTF_GetError() << endl;
-        }
-        else
-        {
-            textTexture = SDL_CreateTextureFromSurface(gRenderer, textSurface);
-            if (textTexture == nullptr)
-            {
-                cout << "Unable to create text texture! SDL Error: " << SDL_GetError() << endl;
-            }
-            else
-            {
-                SDL_RenderCopy(gRenderer, textTexture, nullptr, &textRect);
-                SDL_RenderPresent(gRenderer);
-            }
-        }
-
-        SDL_FreeSurface(textSurface);
-        SDL_DestroyTexture(textTexture);
-        TTF_CloseFont(font);
+        int x = (sc_Width - introGlyphs.measureText(timerText, timerText.length())) / 2;
+        int y = (sc_Height - introGlyphs.lineHeight()) / 2;
+        introGlyphs.drawText(timerText, timerText.length(), x, y, {245, 245, 220, 255});
+        SDL_RenderPresent(gRenderer);
     }
     void renderWonOrLost()
     {
@@ -302,15 +274,30 @@ private:
 
         return texture;
     }
+    // Runs from run() when the time is up and again from the destructor, so
+    // it only drops this game's own SDL_ttf reference once.
     void cleanupSDL()
     {
-        SDL_DestroyRenderer(gRenderer);
-        SDL_DestroyWindow(gWindow);
-        TTF_Quit();
+        introGlyphs.free();
+        if (gRenderer != nullptr)
+        {
+            SDL_DestroyRenderer(gRenderer);
+            gRenderer = nullptr;
+        }
+        if (gWindow != nullptr)
+        {
+            SDL_DestroyWindow(gWindow);
+            gWindow = nullptr;
+        }
+        if (ttfStarted)
+        {
+            TTF_Quit();
+            ttfStarted = false;
+        }
     }
 
 public:
-    MazeGame() : gWindow(nullptr), gRenderer(nullptr), playerRow(1), playerCol(1), gameStarted(false),Won(false), gameDurationInSeconds(90)
+    MazeGame() : gWindow(nullptr), gRenderer(nullptr), ttfStarted(false), playerRow(1), playerCol(1), gameStarted(false),Won(false), gameDurationInSeconds(90)
     {
         if (SDL_Init(SDL_INIT_VIDEO) < 0)
         {
@@ -323,6 +310,7 @@ public:
             cout << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << endl;
             exit(1);
         }
+        ttfStarted = true;
 
         gWindow = SDL_CreateWindow("MAZE GAME", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, sc_Width, sc_Height, SDL_WINDOW_SHOWN);
         if (gWindow == nullptr)
@@ -337,6 +325,11 @@ public:
             cout << "Renderer could not be created! SDL_Error: " << SDL_GetError() << endl;
             exit(1);
         }
+
+        if (!introGlyphs.init(gRenderer, loadSdfFont("JosefinSans-Bold.ttf"), 100))
+        {
+            cout << "Failed to load font! SDL_ttf Error: " << TTF_GetError() << endl;
+        }
         for (int i = 0; i < ROWS; ++i)
         {
             for (int j = 0; j < COLS; ++j)
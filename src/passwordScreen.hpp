@@ -4,251 +4,199 @@
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 #include "LTexture.hpp"
+#include "glyphCache.hpp"
+#include "textInput.hpp"
 using namespace std;
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
-
-
+// How long "Access Granted"/"Access Denied" stays up, the last part of it
+// fading out.
+const Uint32 PASS_RESULT_MS = 1000;
+const Uint32 PASS_FADE_MS = 400;
+
+// Password prompt drawn as a 640x480 panel over the main screen, on the main
+// renderer. Everything it draws is loaded once by init(), so opening it costs
+// nothing and it shows on the next frame. The owner feeds it events while it
+// is active and calls update() and render() every frame; after a submit the
+// result is shown and faded out on the frame clock, then isActive() turns
+// false and isAccessGranted() holds the answer.
 class PassScreen
 {
 public:
     PassScreen();
     ~PassScreen();
-    void run(const string);
+    bool init(SDL_Renderer *renderer, int viewWidth, int viewHeight);
+    void free();
+    void open(const string &expectedPassword);
+    void handleEvent(const SDL_Event &e);
+    void update(Uint32 now);
+    void render();
+    bool isActive() const
+    {
+        return state != PASS_CLOSED;
+    }
     bool isAccessGranted() const
     {
         return accessGranted;
     }
 
 private:
-    SDL_Window *mWindow;
+    enum PassState
+    {
+        PASS_CLOSED,
+        PASS_PROMPT,
+        PASS_RESULT
+    };
+
     SDL_Renderer *mRenderer;
-    TTF_Font *mFont;
     LTexture mPromptTextTexture;
-    LTexture mInputTextTexture;
+    LTexture mGrantedTexture;
+    LTexture mDeniedTexture;
     LTexture mBackgroundTexture;
-    bool renderInputText;
-    bool quit;
+    GlyphCache mInputGlyphs;
+    TextInput mInput;
+    SDL_Rect mPanel;
+    PassState state;
+    string expected;
+    Uint32 resultStart;
+    Uint8 alpha;
     bool accessGranted;
 
-    void initialize();
-    void loadMedia();
-    void handleEvents(bool &quit, std::string &inputText, bool &renderText, SDL_Color textColor,const string);
-    void render();
-    void cleanup();
+    PassScreen(const PassScreen &) = delete;
+    PassScreen &operator=(const PassScreen &) = delete;
 };
 
 PassScreen::PassScreen()
-    : mWindow(NULL), mRenderer(NULL), mFont(NULL), renderInputText(true), quit(false), accessGranted(false)
+    : mRenderer(NULL), mPanel({0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}), state(PASS_CLOSED), resultStart(0), alpha(255), accessGranted(false)
 {
 }
 
 PassScreen::~PassScreen()
 {
-    cleanup();
+    free();
 }
 
-void PassScreen::initialize()
+// The owner has SDL, SDL_image and SDL_ttf running; the panel is centred in
+// a view of the given size. The font is only needed here: the prompts are
+// rendered and the input glyphs cached before it is closed, so nothing the
+// overlay keeps depends on SDL_ttf staying up.
+bool PassScreen::init(SDL_Renderer *renderer, int viewWidth, int viewHeight)
 {
-    if (SDL_Init(SDL_INIT_VIDEO) < 0)
-    {
-        cout << "SDL could not initialize! SDL Error: " << SDL_GetError() << endl;
-        exit(EXIT_FAILURE);
-    }
+    free();
+    mRenderer = renderer;
+    mPanel = {(viewWidth - SCREEN_WIDTH) / 2, (viewHeight - SCREEN_HEIGHT) / 2, SCREEN_WIDTH, SCREEN_HEIGHT};
 
-    if (!SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "1"))
+    TTF_Font *font = TTF_OpenFont("Harting_plain.ttf", 35);
+    if (font == NULL)
     {
-        cout << "Warning: Linear texture filtering not enabled!" << endl;
+        cout << "Failed to load lazy font! SDL_ttf Error: " << TTF_GetError() << endl;
+        return false;
     }
 
-    mWindow = SDL_CreateWindow("Password Screen", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-    if (mWindow == NULL)
-    {
-        cout << "Window could not be created! SDL Error: " << SDL_GetError() << endl;
-        exit(EXIT_FAILURE);
-    }
+    SDL_Color textColor = {255, 255, 255, 255};
 
-    mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    if (mRenderer == NULL)
+    bool loaded = mPromptTextTexture.loadFromRenderedText(mRenderer, font, "Enter Password", textColor) &&
+                  mGrantedTexture.loadFromRenderedText(mRenderer, font, "Access Granted", textColor) &&
+                  mDeniedTexture.loadFromRenderedText(mRenderer, font, "Access Denied", textColor);
+    loaded = loaded && mInputGlyphs.init(mRenderer, font);
+    TTF_CloseFont(font);
+    if (!loaded)
     {
-        cout << "Renderer could not be created! SDL Error: " << SDL_GetError() << endl;
-        exit(EXIT_FAILURE);
+        cout << "Failed to render prompt text!" << endl;
+        return false;
     }
 
-    SDL_SetRenderDrawColor(mRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
-
-    int imgFlags = IMG_INIT_PNG;
-    if (!(IMG_Init(imgFlags) & imgFlags))
+    if (!mBackgroundTexture.loadFromFile(mRenderer, "images/passwordBg.png"))
     {
-        cout << "SDL_image could not initialize! SDL_image Error: " << IMG_GetError() << endl;
-        exit(EXIT_FAILURE);
+        cout << "Failed to load background image!" << endl;
+        return false;
     }
+    mInput.init(mRenderer, &mInputGlyphs);
+    return true;
+}
 
-    if (TTF_Init() == -1)
+// Must run before the renderer is destroyed; safe to call twice.
+void PassScreen::free()
+{
+    if (state == PASS_PROMPT)
     {
-        cout << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << endl;
-        exit(EXIT_FAILURE);
+        mInput.stop();
     }
+    state = PASS_CLOSED;
+    mPromptTextTexture.free();
+    mGrantedTexture.free();
+    mDeniedTexture.free();
+    mBackgroundTexture.free();
+    mInputGlyphs.free();
+    mRenderer = NULL;
 }
 
-void PassScreen::loadMedia()
+void PassScreen::open(const string &expectedPassword)
 {
-    mFont = TTF_OpenFont("Harting_plain.ttf", 35);
-    if (mFont == NULL)
+    expected = expectedPassword;
+    accessGranted = false;
+    alpha = 255;
+    state = PASS_PROMPT;
+    mInput.clear();
+    mInput.start({mPanel.x + SCREEN_WIDTH / 9, mPanel.y + 200, SCREEN_WIDTH * 7 / 9, mInputGlyphs.lineHeight()});
+}
+
+// Escape closes the prompt without an answer, as if access were denied.
+void PassScreen::handleEvent(const SDL_Event &e)
+{
+    if (state != PASS_PROMPT)
     {
-        cout << "Failed to load lazy font! SDL_ttf Error: " << TTF_GetError() << endl;
-        exit(EXIT_FAILURE);
+        return;
     }
-
-    SDL_Color textColor = {255, 255, 255, 255};
-
-    if (!mBackgroundTexture.loadFromFile(mRenderer, "images/passwordBg.png"))
+    if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE)
     {
-        cout << "Failed to load background image!" << endl;
-        exit(EXIT_FAILURE);
+        mInput.stop();
+        state = PASS_CLOSED;
     }
-
-    if (!mPromptTextTexture.loadFromRenderedText(mRenderer, mFont, "Enter Password", textColor))
+    else if (mInput.handleEvent(e) == TEXT_SUBMITTED)
     {
-        cout << "Failed to render prompt text!" << endl;
-        exit(EXIT_FAILURE);
+        mInput.stop();
+        accessGranted = mInput.text() == expected;
+        resultStart = SDL_GetTicks();
+        state = PASS_RESULT;
     }
-    mInputTextTexture.loadFromRenderedText(mRenderer, mFont, " ", textColor);
 }
 
-void PassScreen::handleEvents(bool &quit, std::string &inputText, bool &renderText, SDL_Color textColor,const string expectedPassword)
+void PassScreen::update(Uint32 now)
 {
-    SDL_Event e;
-    while (SDL_PollEvent(&e) != 0)
+    if (state == PASS_PROMPT)
+    {
+        mInput.update(now);
+    }
+    else if (state == PASS_RESULT)
     {
-        if (e.type == SDL_QUIT)
+        Uint32 shown = now - resultStart;
+        if (shown >= PASS_RESULT_MS)
         {
-            quit = true;
+            state = PASS_CLOSED;
         }
-        else
+        else if (shown > PASS_RESULT_MS - PASS_FADE_MS)
         {
-            if (e.type == SDL_KEYDOWN)
-            {
-                if (e.key.keysym.sym == SDLK_BACKSPACE && inputText.length() > 0)
-                {
-                    inputText.pop_back();
-                    renderText = true;
-                }
-                if (e.key.keysym.sym == SDLK_ESCAPE)
-                {
-                    quit = true; 
-                }
-                else if (e.key.keysym.sym == SDLK_RETURN)
-                {
-                    if (inputText == expectedPassword)
-                    {
-                        renderInputText = false;
-                        mPromptTextTexture.free();
-                        mInputTextTexture.free(); 
-                        mPromptTextTexture.loadFromRenderedText(mRenderer, mFont, "Access Granted", textColor);
-                        renderText = true;
-                        accessGranted = true;
-                        quit = true;
-                    }
-                    else
-                    {
-                        renderInputText = false;
-                        mPromptTextTexture.free();
-                        mInputTextTexture.free(); 
-                        mPromptTextTexture.loadFromRenderedText(mRenderer, mFont, "Access Denied", textColor);
-                        renderText = true;
-                        accessGranted = false;
-                        quit = true;
-                    }
-                }
-                else if (e.key.keysym.sym == SDLK_c && SDL_GetModState() & KMOD_CTRL)
-                {
-                    SDL_SetClipboardText(inputText.c_str());
-                }
-                else if (e.key.keysym.sym == SDLK_v && SDL_GetModState() & KMOD_CTRL)
-                {
-                    char *tempText = SDL_GetClipboardText();
-                    inputText = tempText;
-                    SDL_free(tempText);
-                    renderText = true;
-                }
-            }
-            else if (e.type == SDL_TEXTINPUT)
-            {
-                if (!(SDL_GetModState() & KMOD_CTRL && (e.text.text[0] == 'c' || e.text.text[0] == 'C' || e.text.text[0] == 'v' || e.text.text[0] == 'V')))
-                {
-                    inputText += e.text.text;
-                    renderText = true;
-                }
-            }
+            alpha = (Uint8)(255 * (PASS_RESULT_MS - shown) / PASS_FADE_MS);
         }
     }
 }
 
 void PassScreen::render()
 {
-    SDL_SetRenderDrawColor(mRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
-    SDL_RenderClear(mRenderer);
-
-    mBackgroundTexture.render(mRenderer, 0, 0);
-
-    mPromptTextTexture.render(mRenderer, (SCREEN_WIDTH - mPromptTextTexture.getWidth()) / 12, 100);
-    if (renderInputText)
+    if (state == PASS_CLOSED)
     {
-        mInputTextTexture.render(mRenderer, (SCREEN_WIDTH - mInputTextTexture.getWidth()) / 9, 200);
+        return;
     }
 
-    SDL_RenderPresent(mRenderer);
-}
-
-void PassScreen::cleanup()
-{
-    mPromptTextTexture.free();
-    mInputTextTexture.free();
-    mBackgroundTexture.free();
-    TTF_CloseFont(mFont);
-    mFont = NULL;
-    SDL_DestroyRenderer(mRenderer);
-    SDL_DestroyWindow(mWindow);
-    mWindow = NULL;
-    mRenderer = NULL;
-    TTF_Quit();
-    IMG_Quit();
-}
-
-void PassScreen::run(const string pass)
-{
-    initialize();
-    loadMedia();
-
-    SDL_Color textColor = {255, 255, 255, 255};
-    std::string inputText = "";
-    mInputTextTexture.loadFromRenderedText(mRenderer, mFont, inputText.c_str(), textColor);
-    SDL_StartTextInput();
-
-    while (!quit && !accessGranted)
+    LTexture &prompt = state == PASS_RESULT ? (accessGranted ? mGrantedTexture : mDeniedTexture) : mPromptTextTexture;
+    mBackgroundTexture.setAlpha(alpha);
+    prompt.setAlpha(alpha);
+    mBackgroundTexture.render(mRenderer, mPanel.x, mPanel.y);
+    prompt.render(mRenderer, mPanel.x + (SCREEN_WIDTH - prompt.getWidth()) / 12, mPanel.y + 100);
+    if (state == PASS_PROMPT)
     {
-        bool renderText = false;
-        handleEvents(quit, inputText, renderText, textColor,pass);
-
-        if (renderText)
-        {
-            if (inputText != "")
-            {
-                mInputTextTexture.loadFromRenderedText(mRenderer, mFont, inputText.c_str(), textColor);
-            }
-            else
-            {
-                mInputTextTexture.loadFromRenderedText(mRenderer, mFont, " ", textColor);
-            }
-        }
-
-        render();
+        mInput.render(mPanel.x + (SCREEN_WIDTH - mInput.width()) / 9, mPanel.y + 200, {255, 255, 255, 255});
     }
-
-    SDL_Delay(1000);
-
-    SDL_StopTextInput();
-    cleanup();
 }
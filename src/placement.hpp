@@ -0,0 +1,226 @@
+#ifndef PLACEMENT_HPP
+#define PLACEMENT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <SDL2/SDL_rect.h>
+#include "spatialGrid.hpp"
+using namespace std;
+
+// One object to place. The caller fills in width and height; place() fills
+// in x, y and whether a spot was found.
+struct Placement
+{
+    int width, height;
+    int x, y;
+    bool placed;
+};
+
+// Scatters rectangles over an area with Poisson-disk (Bridson) sampling.
+// Every object keeps at least `spacing` pixels of free space around it and
+// never touches a forbidden region. New spots are grown outwards from already
+// placed ones and only the neighbouring grid cells are checked for overlap,
+// so placing n objects costs about O(n) instead of the O(n^2) of throwing
+// darts and scanning every earlier object.
+class PoissonPlacer
+{
+public:
+    PoissonPlacer(const SDL_Rect &area, int minSpacing = 0, int attempts = 30);
+    void addForbidden(const SDL_Rect &rect);
+    int place(vector<Placement> &items, mt19937 &gen);
+    int getSpacing() const;
+
+private:
+    struct Blocker
+    {
+        SDL_Rect rect;
+        bool keepsSpacing;
+    };
+
+    SDL_Rect mArea;
+    int mMinSpacing, mAttempts, mSpacing;
+    vector<SDL_Rect> mForbidden;
+    vector<Blocker> mBlockers;
+    SpatialGrid mGrid;
+    vector<int> mCandidates;
+
+    int chooseSpacing(const vector<Placement> &items) const;
+    bool fits(int x, int y, int width, int height);
+    void block(const SDL_Rect &rect, bool keepsSpacing);
+};
+
+PoissonPlacer::PoissonPlacer(const SDL_Rect &area, int minSpacing, int attempts)
+    : mArea(area), mMinSpacing(max(minSpacing, 0)), mAttempts(max(attempts, 1)), mSpacing(0)
+{
+}
+
+void PoissonPlacer::addForbidden(const SDL_Rect &rect)
+{
+    mForbidden.push_back(rect);
+}
+
+int PoissonPlacer::getSpacing() const
+{
+    return mSpacing;
+}
+
+// Spreads the objects over the whole area: the gap is grown until n padded
+// objects would cover a bit under half of the free area, which a maximal
+// Poisson-disk set still reaches comfortably.
+int PoissonPlacer::chooseSpacing(const vector<Placement> &items) const
+{
+    if (items.empty())
+    {
+        return mMinSpacing;
+    }
+    double freeArea = (double)mArea.w * mArea.h;
+    for (const SDL_Rect &rect : mForbidden)
+    {
+        int overlapW = min(rect.x + rect.w, mArea.x + mArea.w) - max(rect.x, mArea.x);
+        int overlapH = min(rect.y + rect.h, mArea.y + mArea.h) - max(rect.y, mArea.y);
+        if (overlapW > 0 && overlapH > 0)
+        {
+            freeArea -= (double)overlapW * overlapH;
+        }
+    }
+    freeArea = max(freeArea, (double)mArea.w * mArea.h / 4);
+
+    double averageSide = 0;
+    for (const Placement &item : items)
+    {
+        averageSide += (item.width + item.height) / 2.0;
+    }
+    averageSide /= items.size();
+
+    int gap = (int)(sqrt(0.45 * freeArea / items.size()) - averageSide);
+    return max(gap, mMinSpacing);
+}
+
+bool PoissonPlacer::fits(int x, int y, int width, int height)
+{
+    if (x < mArea.x || y < mArea.y || x + width > mArea.x + mArea.w || y + height > mArea.y + mArea.h)
+    {
+        return false;
+    }
+    // The grid lives in area-local coordinates.
+    SDL_Rect padded = {x - mArea.x - mSpacing, y - mArea.y - mSpacing, width + 2 * mSpacing, height + 2 * mSpacing};
+    SDL_Rect exact = {x - mArea.x, y - mArea.y, width, height};
+    mGrid.queryRect(padded, mCandidates);
+    for (int id : mCandidates)
+    {
+        const Blocker &blocker = mBlockers[id];
+        const SDL_Rect &probe = blocker.keepsSpacing ? padded : exact;
+        if (probe.x < blocker.rect.x + blocker.rect.w && probe.x + probe.w > blocker.rect.x &&
+            probe.y < blocker.rect.y + blocker.rect.h && probe.y + probe.h > blocker.rect.y)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PoissonPlacer::block(const SDL_Rect &rect, bool keepsSpacing)
+{
+    SDL_Rect local = {rect.x - mArea.x, rect.y - mArea.y, rect.w, rect.h};
+    mGrid.insert((int)mBlockers.size(), local);
+    mBlockers.push_back({local, keepsSpacing});
+}
+
+// Places the items in a random order so that consecutive items do not end up
+// side by side. Returns how many were placed; the rest have placed == false
+// (only possible when the area is too crowded or cut up by forbidden rects).
+int PoissonPlacer::place(vector<Placement> &items, mt19937 &gen)
+{
+    mSpacing = chooseSpacing(items);
+    int largest = 1;
+    for (Placement &item : items)
+    {
+        item.placed = false;
+        largest = max(largest, max(item.width, item.height));
+    }
+    // A padded object then spans at most 3x3 cells.
+    mGrid.reset(mArea.w, mArea.h, largest + mSpacing);
+    mBlockers.clear();
+    for (const SDL_Rect &rect : mForbidden)
+    {
+        block(rect, false);
+    }
+
+    vector<int> order(items.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = (int)i;
+    }
+    shuffle(order.begin(), order.end(), gen);
+
+    const double twoPi = 6.283185307179586;
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    vector<int> active;
+    size_t next = 0;
+    int placedCount = 0;
+
+    while (next < order.size())
+    {
+        Placement &item = items[order[next]];
+        bool found = false;
+
+        // Grow from a random active object: try spots in the ring between
+        // "just touching" and twice that distance, centre to centre.
+        while (!found && !active.empty())
+        {
+            size_t slot = (size_t)(unit(gen) * active.size()) % active.size();
+            const Placement &from = items[active[slot]];
+            double inner = (max(from.width, from.height) + max(item.width, item.height)) / 2.0 + mSpacing;
+            double centerX = from.x + from.width / 2.0;
+            double centerY = from.y + from.height / 2.0;
+            for (int attempt = 0; attempt < mAttempts && !found; ++attempt)
+            {
+                double angle = twoPi * unit(gen);
+                double radius = inner * (1.0 + unit(gen));
+                int x = (int)lround(centerX + radius * cos(angle) - item.width / 2.0);
+                int y = (int)lround(centerY + radius * sin(angle) - item.height / 2.0);
+                if (fits(x, y, item.width, item.height))
+                {
+                    item.x = x;
+                    item.y = y;
+                    found = true;
+                }
+            }
+            // As in Bridson's algorithm, an object whose ring is full is
+            // retired, which keeps the whole pass linear.
+            if (!found)
+            {
+                active[slot] = active.back();
+                active.pop_back();
+            }
+        }
+
+        // No active object left (first item, or a region filled up): start a
+        // new cluster with a few uniformly random throws.
+        for (int attempt = 0; attempt < mAttempts && !found; ++attempt)
+        {
+            int x = mArea.x + (int)(unit(gen) * max(mArea.w - item.width + 1, 1));
+            int y = mArea.y + (int)(unit(gen) * max(mArea.h - item.height + 1, 1));
+            if (fits(x, y, item.width, item.height))
+            {
+                item.x = x;
+                item.y = y;
+                found = true;
+            }
+        }
+
+        if (found)
+        {
+            item.placed = true;
+            block({item.x, item.y, item.width, item.height}, true);
+            active.push_back(order[next]);
+            ++placedCount;
+        }
+        ++next;
+    }
+    return placedCount;
+}
+
+#endif
@@ -0,0 +1,281 @@
+#ifndef POTIONCATALOG_HPP
+#define POTIONCATALOG_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string_view>
+#include <vector>
+#include "contentStore.hpp"
+using namespace std;
+
+// Potions in a dense vector indexed by id, with:
+//  - an open-addressing hash index from scenario to id,
+//  - an alias table (Walker/Vose) so a weighted pick is one uniform draw
+//    and one coin flip whatever the catalog size,
+//  - a ring of the most recent picks that the next picks avoid.
+// The views point into the content store, which must outlive the catalog.
+const int DEFAULT_POTION_DIFFICULTY = 2;
+const int MAX_RECENT_REDRAWS = 16;
+
+struct PotionEntry
+{
+    string_view scenario;
+    string_view code;
+    int difficulty;
+};
+
+class PotionCatalog
+{
+public:
+    PotionCatalog();
+    void build(const vector<PotionEntry> &entries);
+    void build(const ContentStore &store);
+    size_t size() const;
+    const PotionEntry &entry(size_t id) const;
+    long find(string_view scenario) const;
+    void setWeights(const vector<double> &weights);
+    void weightByDifficulty(int target);
+    void setRecentWindow(size_t window);
+    size_t pick(mt19937 &gen);
+
+private:
+    vector<PotionEntry> mEntries;
+    vector<uint32_t> mSlots;
+    vector<double> mProbability;
+    vector<uint32_t> mAlias;
+    vector<uint32_t> mRecent;
+    vector<unsigned char> mRecentCount;
+    size_t mRecentWindow, mRecentNext;
+
+    static size_t hashScenario(string_view text);
+    void buildIndex();
+    size_t draw(mt19937 &gen) const;
+    void remember(size_t id);
+};
+
+PotionCatalog::PotionCatalog()
+{
+    mRecentWindow = 0;
+    mRecentNext = 0;
+}
+
+// The library string hash reads eight bytes a step, which matters for
+// scenarios a sentence long.
+size_t PotionCatalog::hashScenario(string_view text)
+{
+    return std::hash<string_view>()(text);
+}
+
+// Slots hold id + 1 (0 is empty); the table is kept at most half full so
+// linear probes stay short. A repeated scenario keeps its first id.
+void PotionCatalog::buildIndex()
+{
+    size_t capacity = 16;
+    while (capacity < 2 * mEntries.size())
+    {
+        capacity *= 2;
+    }
+    mSlots.assign(capacity, 0);
+    for (size_t id = 0; id < mEntries.size(); ++id)
+    {
+        size_t slot = hashScenario(mEntries[id].scenario) & (capacity - 1);
+        while (mSlots[slot] != 0 && mEntries[mSlots[slot] - 1].scenario != mEntries[id].scenario)
+        {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if (mSlots[slot] == 0)
+        {
+            mSlots[slot] = (uint32_t)id + 1;
+        }
+    }
+}
+
+void PotionCatalog::build(const vector<PotionEntry> &entries)
+{
+    mEntries = entries;
+    buildIndex();
+    setWeights(vector<double>(mEntries.size(), 1.0));
+    mRecent.clear();
+    mRecentCount.assign(mEntries.size(), 0);
+    mRecentNext = 0;
+    setRecentWindow(mRecentWindow);
+}
+
+// Fields: scenario, code and difficulty (a number, empty for the default).
+void PotionCatalog::build(const ContentStore &store)
+{
+    vector<PotionEntry> entries(store.size());
+    for (size_t id = 0; id < store.size(); ++id)
+    {
+        string_view difficulty = store.field(id, 2);
+        entries[id].scenario = store.field(id, 0);
+        entries[id].code = store.field(id, 1);
+        entries[id].difficulty = DEFAULT_POTION_DIFFICULTY;
+        if (!difficulty.empty())
+        {
+            int value = 0;
+            for (char c : difficulty)
+            {
+                value = value * 10 + (c - '0');
+            }
+            entries[id].difficulty = value;
+        }
+    }
+    build(entries);
+}
+
+size_t PotionCatalog::size() const
+{
+    return mEntries.size();
+}
+
+const PotionEntry &PotionCatalog::entry(size_t id) const
+{
+    return mEntries[id];
+}
+
+// Id of the potion with this scenario, or -1.
+long PotionCatalog::find(string_view scenario) const
+{
+    if (mSlots.empty())
+    {
+        return -1;
+    }
+    size_t mask = mSlots.size() - 1;
+    for (size_t slot = hashScenario(scenario) & mask; mSlots[slot] != 0; slot = (slot + 1) & mask)
+    {
+        if (mEntries[mSlots[slot] - 1].scenario == scenario)
+        {
+            return (long)mSlots[slot] - 1;
+        }
+    }
+    return -1;
+}
+
+// Vose's alias construction: columns below the mean weight are topped up
+// from one column above it, so every column holds at most two ids. O(n).
+void PotionCatalog::setWeights(const vector<double> &weights)
+{
+    size_t n = mEntries.size();
+    mProbability.assign(n, 1.0);
+    mAlias.resize(n);
+    double total = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        mAlias[i] = (uint32_t)i;
+        total += i < weights.size() ? max(0.0, weights[i]) : 0.0;
+    }
+    if (n == 0 || total <= 0)
+    {
+        return;
+    }
+
+    vector<double> scaled(n);
+    vector<uint32_t> small, large;
+    for (size_t i = 0; i < n; ++i)
+    {
+        scaled[i] = (i < weights.size() ? max(0.0, weights[i]) : 0.0) * n / total;
+        (scaled[i] < 1.0 ? small : large).push_back((uint32_t)i);
+    }
+    while (!small.empty() && !large.empty())
+    {
+        uint32_t less = small.back();
+        uint32_t more = large.back();
+        small.pop_back();
+        mProbability[less] = scaled[less];
+        mAlias[less] = more;
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // Whatever is left is 1 up to rounding.
+    for (uint32_t i : small)
+    {
+        mProbability[i] = 1.0;
+    }
+    for (uint32_t i : large)
+    {
+        mProbability[i] = 1.0;
+    }
+}
+
+// Potions nearest the target difficulty come up most: weight 1 at the
+// target, 1/2 one step away, 1/3 two steps away, and so on.
+void PotionCatalog::weightByDifficulty(int target)
+{
+    vector<double> weights(mEntries.size());
+    for (size_t i = 0; i < mEntries.size(); ++i)
+    {
+        weights[i] = 1.0 / (1 + abs(mEntries[i].difficulty - target));
+    }
+    setWeights(weights);
+}
+
+// The window is kept below the catalog size so there is always something
+// left to pick.
+void PotionCatalog::setRecentWindow(size_t window)
+{
+    mRecentWindow = window;
+    size_t effective = mEntries.empty() ? 0 : min(window, mEntries.size() - 1);
+    while (mRecent.size() > effective)
+    {
+        mRecentCount[mRecent.back()]--;
+        mRecent.pop_back();
+    }
+    mRecentNext = effective == 0 ? 0 : mRecentNext % effective;
+    mRecent.reserve(effective);
+}
+
+size_t PotionCatalog::draw(mt19937 &gen) const
+{
+    uniform_int_distribution<size_t> column(0, mEntries.size() - 1);
+    uniform_real_distribution<double> coin(0.0, 1.0);
+    size_t i = column(gen);
+    return coin(gen) < mProbability[i] ? i : mAlias[i];
+}
+
+void PotionCatalog::remember(size_t id)
+{
+    size_t effective = mEntries.empty() ? 0 : min(mRecentWindow, mEntries.size() - 1);
+    if (effective == 0)
+    {
+        return;
+    }
+    if (mRecent.size() < effective)
+    {
+        mRecent.push_back((uint32_t)id);
+    }
+    else
+    {
+        mRecentCount[mRecent[mRecentNext]]--;
+        mRecent[mRecentNext] = (uint32_t)id;
+    }
+    mRecentCount[id]++;
+    mRecentNext = (mRecentNext + 1) % effective;
+}
+
+// The catalog must not be empty. Re-draws while the pick is among the
+// recent ones; with a window well below the catalog size that is rarely more
+// than one draw. Only when the weights pile onto the recent potions does it
+// give up and step to the next potion that is not recent.
+size_t PotionCatalog::pick(mt19937 &gen)
+{
+    size_t id = draw(gen);
+    for (int redraw = 0; redraw < MAX_RECENT_REDRAWS && mRecentCount[id] != 0; ++redraw)
+    {
+        id = draw(gen);
+    }
+    while (mRecentCount[id] != 0)
+    {
+        id = (id + 1) % mEntries.size();
+    }
+    remember(id);
+    return id;
+}
+
+#endif
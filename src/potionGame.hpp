@@ -2,14 +2,18 @@
 #include <fstream>
 #include <sstream>
 #include <vector>
-#include <unordered_map>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_image.h>
 #include <cstdlib>
 #include <ctime>
+#include "contentStore.hpp"
+#include "potionCatalog.hpp"
 #include "imageViewer.hpp"
 #include "LTexture.hpp"
+#include "glyphCache.hpp"
+#include "textLayout.hpp"
+#include "textInput.hpp"
 
 using namespace std;
 
@@ -22,17 +26,40 @@ TTF_Font *font;
 SDL_Texture *startTexture;
 SDL_Rect startButtonRect;
 bool gameStarted = false, won = false;
+
+// Scenario, code and difficulty of every potion; the catalog indexes them and
+// draws which one the player has to brew. A game object lasts one play, so
+// the deck lives for the whole session and the catalog's recent picks carry
+// over from one play to the next.
+struct PotionDeck
+{
+    ContentStore potions;
+    PotionCatalog catalog;
+    mt19937 random;
+    bool loaded = false;
+};
+
+PotionDeck &potionDeck()
+{
+    static PotionDeck deck;
+    return deck;
+}
+
 class PotionMixingGame
 {
 private:
-    unordered_map<string, string> potions;
+    PotionDeck &deck;
     SDL_Rect inputRect;
     LTexture gPromptTextTexture;
-    LTexture gInputTextTexture;
     LTexture gBackgroundTexture;
+    GlyphCache storyGlyphs;
+    GlyphCache inputGlyphs;
+    TextInput input;
     string selectedPotionCode;
+    bool ttfStarted;
     void loadMedia();
-    void renderText(string, int, int, bool, int);
+    void renderText(const string &text, int x, int y);
+    void renderParagraph(string_view text, int x, int y, int maxWidth);
     void renderWonOrLost();
     string getUserInputSDL();
 
@@ -40,20 +67,20 @@ public:
     PotionMixingGame();
     ~PotionMixingGame();
     void initializeSDL();
-    void readPotionsFromFile(const string &filename);
+    void openPotions(const string &filename);
     void displayAvailablePotions();
-    void createPotion(const string &chosenPotion);
-    void IngredientSequenceForChosen(const string &chosenPotion);
-    string getRandomPotion();
+    void createPotion(size_t chosenPotion);
+    void IngredientSequenceForChosen(string_view scenario);
+    size_t getRandomPotion();
     string run();
     void cleanUp();
     bool WonOrLost();
 };
 
-PotionMixingGame::PotionMixingGame()
+PotionMixingGame::PotionMixingGame() : deck(potionDeck()), ttfStarted(false)
 {
     initializeSDL();
-    readPotionsFromFile("textFiles/potions.txt");
+    openPotions("textFiles/potions.bin");
     loadMedia();
 }
 
@@ -75,6 +102,7 @@ void PotionMixingGame::initializeSDL()
         cout << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << endl;
         exit(EXIT_FAILURE);
     }
+    ttfStarted = true;
 
     window = SDL_CreateWindow("Potion Mixing Game", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width, height, SDL_WINDOW_SHOWN);
     if (!window)
@@ -91,11 +119,13 @@ void PotionMixingGame::initializeSDL()
     }
 
     font = TTF_OpenFont("JosefinSans-Bold.ttf", 25);
-    if (!font)
+    const SdfFont *storyFont = loadSdfFont("JosefinSans-Bold.ttf");
+    if (!font || !storyGlyphs.init(renderer, storyFont, 20) || !inputGlyphs.init(renderer, storyFont, 25))
     {
         cout << "Failed to load font: " << TTF_GetError() << endl;
         exit(EXIT_FAILURE);
     }
+    input.init(renderer, &inputGlyphs);
 }
 
 void PotionMixingGame::loadMedia()
@@ -107,67 +137,25 @@ void PotionMixingGame::loadMedia()
     }
 }
 
-void PotionMixingGame::renderText(string text, int x, int y, bool wrapText, int fontSize)
+void PotionMixingGame::renderText(const string &text, int x, int y)
 {
     SDL_Color textColor = {255, 255, 255};
-    TTF_Font *customFont;
-    if (fontSize > 0)
-    {
-        customFont = TTF_OpenFont("JosefinSans-Bold.ttf", fontSize);
-        if (!customFont)
-        {
-            cout << "Failed to load custom font: " << TTF_GetError() << endl;
-            exit(EXIT_FAILURE);
-        }
-    }
-    else
-    {
-        customFont = font;
-    }
-
-    if (wrapText)
-    {
-        int wrapLength = 62;
-        vector<string> wrappedLines;
-
-        size_t startPos = 0;
-        while (startPos < text.length())
-        {
-            size_t endPos = min(startPos + wrapLength, text.length());
-            size_t lastSpace = text.find_last_of(" ", endPos);
-            if (lastSpace != std::string::npos && lastSpace > startPos)
-            {
-                endPos = lastSpace;
-            }
-            wrappedLines.push_back(text.substr(startPos, endPos - startPos));
-            startPos = endPos + 1;
-        }
+    gPromptTextTexture.loadFromRenderedText(renderer, font, text, textColor);
+    gPromptTextTexture.render(renderer, x, y);
+}
 
-        int yOffset = y;
-        for (const auto &line : wrappedLines)
-        {
-            gPromptTextTexture.loadFromRenderedText(renderer, customFont, line, textColor);
-            gPromptTextTexture.render(renderer, x, yOffset);
-            yOffset += gPromptTextTexture.getHeight();
-        }
-    }
-    else
-    {
-        gPromptTextTexture.loadFromRenderedText(renderer, customFont, text, textColor);
-        gPromptTextTexture.render(renderer, x, y);
-    }
-    if (fontSize > 0)
-    {
-        TTF_CloseFont(customFont);
-    }
+// Word-wrapped to maxWidth pixels in the 20pt story font.
+void PotionMixingGame::renderParagraph(string_view text, int x, int y, int maxWidth)
+{
+    TextLayout layout;
+    layoutText(storyGlyphs, text, maxWidth, layout);
+    drawLayout(storyGlyphs, text, layout, x, y, {255, 255, 255, 255});
 }
 
 string PotionMixingGame::getUserInputSDL()
 {
-    bool renderText = true;
-    string inputText;
-
-    SDL_StartTextInput();
+    input.clear();
+    input.start({250, 250, width - 300, inputGlyphs.lineHeight()});
 
     bool inputCompleted = false;
     SDL_Event e;
@@ -182,89 +170,44 @@ string PotionMixingGame::getUserInputSDL()
                 cleanUp();
                 exit(EXIT_SUCCESS);
             }
-            else if (e.type == SDL_KEYDOWN)
-            {
-                if (e.key.keysym.sym == SDLK_RETURN || e.key.keysym.sym == SDLK_KP_ENTER)
-                {
-                    inputCompleted = true;
-                }
-                else if (e.key.keysym.sym == SDLK_BACKSPACE && inputText.length() > 0)
-                {
-                    inputText.pop_back();
-                    renderText = true;
-                }
-                else if (e.key.keysym.sym == SDLK_c && SDL_GetModState() & KMOD_CTRL)
-                {
-                    SDL_SetClipboardText(inputText.c_str());
-                }
-                else if (e.key.keysym.sym == SDLK_v && SDL_GetModState() & KMOD_CTRL)
-                {
-                    char *tempText = SDL_GetClipboardText();
-                    inputText = tempText;
-                    SDL_free(tempText);
-                    renderText = true;
-                }
-            }
-            else if (e.type == SDL_TEXTINPUT)
+            else if (input.handleEvent(e) == TEXT_SUBMITTED)
             {
-                if (!(SDL_GetModState() & KMOD_CTRL && (e.text.text[0] == 'c' || e.text.text[0] == 'C' || e.text.text[0] == 'v' || e.text.text[0] == 'V')))
-                {
-                    inputText += e.text.text;
-                    renderText = true;
-                }
+                inputCompleted = true;
             }
         }
 
-        if (renderText)
+        if (input.update(SDL_GetTicks()))
         {
             SDL_RenderClear(renderer);
 
             gBackgroundTexture.render(renderer, 0, 0);
             gPromptTextTexture.render(renderer, 100, 200);
-
-            if (inputText != "")
-            {
-                gInputTextTexture.loadFromRenderedText(renderer, font, inputText, {255, 255, 255});
-                gInputTextTexture.render(renderer, 250, 250);
-            }
-            else
-            {
-                gInputTextTexture.loadFromRenderedText(renderer, font, " ", {255, 255, 255});
-                gInputTextTexture.render(renderer, 200, 250);
-            }
+            input.render(250, 250, {255, 255, 255, 255});
 
             SDL_RenderPresent(renderer);
-            renderText = false;
         }
     }
 
-    SDL_StopTextInput();
-    return inputText;
+    input.stop();
+    return input.text();
 }
 
-void PotionMixingGame::readPotionsFromFile(const string &filename)
+void PotionMixingGame::openPotions(const string &filename)
 {
-    ifstream file(filename);
-    if (!file.is_open())
+    if (deck.loaded)
     {
-        cout << "Error: Unable to open file " << filename << endl;
-        exit(EXIT_FAILURE);
+        return;
     }
-
-    string line;
-    while (getline(file, line))
+    if (!deck.potions.open(filename, 3) || deck.potions.size() == 0)
     {
-        size_t delimiterPos = line.find("!");
-        if (delimiterPos != string::npos)
-        {
-            string scenario = line.substr(0, delimiterPos);
-            string code = line.substr(delimiterPos + 1);
-
-            potions[scenario] = code;
-        }
+        cout << "Error: Unable to load potions from " << filename << endl;
+        exit(EXIT_FAILURE);
     }
-
-    file.close();
+    deck.catalog.build(deck.potions);
+    deck.catalog.weightByDifficulty(DEFAULT_POTION_DIFFICULTY);
+    deck.catalog.setRecentWindow(3);
+    deck.random.seed((unsigned int)time(nullptr));
+    deck.loaded = true;
 }
 
 void PotionMixingGame::displayAvailablePotions()
@@ -286,6 +229,7 @@ void PotionMixingGame::displayAvailablePotions()
     Uint32 duration = 10000;
     while (!quit && (SDL_GetTicks() - startTime) < duration)
     {
+        imageViewer.update();
         while (SDL_PollEvent(&e) != 0)
         {
             if (e.type == SDL_QUIT)
@@ -298,26 +242,28 @@ void PotionMixingGame::displayAvailablePotions()
                 {
                 case SDLK_RIGHT:
                     imageViewer.nextImage();
-                    imageViewer.displayCurrentImage();
                     break;
                 case SDLK_LEFT:
                     imageViewer.prevImage();
-                    imageViewer.displayCurrentImage();
                     break;
                 }
             }
         }
+        if (imageViewer.isAnimating())
+        {
+            imageViewer.displayCurrentImage();
+        }
     }
     SDL_RenderClear(renderer);
     SDL_RenderPresent(renderer);
 }
 
-void PotionMixingGame::createPotion(const string &chosenPotion)
+void PotionMixingGame::createPotion(size_t chosenPotion)
 {
-    string potionCode = potions[chosenPotion];
-    IngredientSequenceForChosen(chosenPotion);
+    string potionCode(deck.catalog.entry(chosenPotion).code);
+    IngredientSequenceForChosen(deck.catalog.entry(chosenPotion).scenario);
 
-    renderText("Enter the potion code you think is suitable here:", 100, 250, false,0);
+    renderText("Enter the potion code you think is suitable here:", 100, 250);
     SDL_RenderPresent(renderer);
     string userInput = getUserInputSDL();
 
@@ -385,22 +331,19 @@ void PotionMixingGame::renderWonOrLost()
     SDL_DestroyTexture(textTexture);
     TTF_CloseFont(font);
 }
-void PotionMixingGame::IngredientSequenceForChosen(const string &chosenPotion)
+void PotionMixingGame::IngredientSequenceForChosen(string_view scenario)
 {
     SDL_RenderClear(renderer);
     gBackgroundTexture.render(renderer, 0, 0);
 
-    renderText(chosenPotion, 60, 60, true,20);
+    renderParagraph(scenario, 60, 60, width - 120);
 
     SDL_RenderPresent(renderer);
     SDL_Delay(5000);
 }
-string PotionMixingGame::getRandomPotion()
+size_t PotionMixingGame::getRandomPotion()
 {
-    int randomIndex = rand() % potions.size();
-    auto it = begin(potions);
-    advance(it, randomIndex);
-    return it->first;
+    return deck.catalog.pick(deck.random);
 }
 
 void renderStartScreen()
@@ -423,12 +366,40 @@ void handleStartButtonClick(int mouseX, int mouseY)
         gameStarted = true;
     }
 }
+// run() and the destructor both clean up, so everything is nulled and
+// TTF_Quit only answers this game's own TTF_Init: the main screen holds its
+// own reference for the whole session.
 void PotionMixingGame::cleanUp()
 {
-    SDL_DestroyTexture(startTexture);
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
-    TTF_Quit();
+    storyGlyphs.free();
+    inputGlyphs.free();
+    gPromptTextTexture.free();
+    gBackgroundTexture.free();
+    if (startTexture != nullptr)
+    {
+        SDL_DestroyTexture(startTexture);
+        startTexture = nullptr;
+    }
+    if (renderer != nullptr)
+    {
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    }
+    if (window != nullptr)
+    {
+        SDL_DestroyWindow(window);
+        window = nullptr;
+    }
+    if (font != nullptr)
+    {
+        TTF_CloseFont(font);
+        font = nullptr;
+    }
+    if (ttfStarted)
+    {
+        TTF_Quit();
+        ttfStarted = false;
+    }
     IMG_Quit();
 }
 string PotionMixingGame::run()
@@ -466,8 +437,8 @@ string PotionMixingGame::run()
     }
 
     displayAvailablePotions();
-    string chosenPotion = getRandomPotion();
-    cout << "You need to create the potion: " << chosenPotion << endl;
+    size_t chosenPotion = getRandomPotion();
+    cout << "You need to create the potion: " << deck.catalog.entry(chosenPotion).scenario << endl;
     createPotion(chosenPotion);
     renderWonOrLost();
     cleanUp();
@@ -0,0 +1,149 @@
+#ifndef PUZZLEPACK_HPP
+#define PUZZLEPACK_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "mappedFile.hpp"
+using namespace std;
+
+// Binary layout written by tools/puzzleGen (little-endian):
+//   PuzzlePackHeader
+//   PuzzleRecord[count]          at recordOffset
+//   text blob of textSize bytes  at textOffset
+// Record strings are offsets into the blob and are not NUL-terminated.
+enum PuzzleCipher
+{
+    PUZZLE_CAESAR = 0,
+    PUZZLE_ATBASH = 1
+};
+
+struct PuzzlePackHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t recordOffset;
+    uint32_t textOffset;
+    uint32_t textSize;
+};
+
+struct PuzzleRecord
+{
+    uint32_t plainOffset;
+    uint32_t cipherOffset;
+    uint8_t length;
+    uint8_t cipher;
+    uint8_t key;
+    uint8_t difficulty;
+};
+
+const char PUZZLE_PACK_MAGIC[4] = {'E', 'R', 'P', 'Z'};
+const uint32_t PUZZLE_PACK_VERSION = 1;
+
+struct Puzzle
+{
+    string_view plainText;
+    string_view cipherText;
+    int cipher;
+    int key;
+    int difficulty;
+};
+
+// Memory-mapped view of a puzzle pack. Nothing is parsed or copied on open,
+// so picking a puzzle is a single record lookup.
+class PuzzlePack
+{
+public:
+    PuzzlePack();
+    bool open(const string &path);
+    size_t size() const;
+    bool get(size_t index, Puzzle &puzzle) const;
+    bool sample(uint32_t random, Puzzle &puzzle) const;
+
+private:
+    MappedFile mFile;
+    const PuzzleRecord *mRecords;
+    const char *mText;
+    size_t mCount;
+    size_t mTextSize;
+};
+
+PuzzlePack::PuzzlePack()
+{
+    mRecords = NULL;
+    mText = NULL;
+    mCount = 0;
+    mTextSize = 0;
+}
+
+bool PuzzlePack::open(const string &path)
+{
+    mRecords = NULL;
+    mText = NULL;
+    mCount = 0;
+    mTextSize = 0;
+    if (!mFile.open(path))
+    {
+        return false;
+    }
+
+    PuzzlePackHeader header;
+    if (mFile.size() < sizeof(header))
+    {
+        cout << "Puzzle pack " << path << " is truncated!" << endl;
+        return false;
+    }
+    memcpy(&header, mFile.data(), sizeof(header));
+    if (memcmp(header.magic, PUZZLE_PACK_MAGIC, 4) != 0 || header.version != PUZZLE_PACK_VERSION)
+    {
+        cout << "Puzzle pack " << path << " has an unknown format!" << endl;
+        return false;
+    }
+    if (header.recordOffset % alignof(PuzzleRecord) != 0 ||
+        (uint64_t)header.recordOffset + (uint64_t)header.count * sizeof(PuzzleRecord) > mFile.size() ||
+        (uint64_t)header.textOffset + header.textSize > mFile.size())
+    {
+        cout << "Puzzle pack " << path << " is truncated!" << endl;
+        return false;
+    }
+
+    mRecords = (const PuzzleRecord *)(mFile.data() + header.recordOffset);
+    mText = mFile.data() + header.textOffset;
+    mCount = header.count;
+    mTextSize = header.textSize;
+    return true;
+}
+
+size_t PuzzlePack::size() const
+{
+    return mCount;
+}
+
+bool PuzzlePack::get(size_t index, Puzzle &puzzle) const
+{
+    if (index >= mCount)
+    {
+        return false;
+    }
+    const PuzzleRecord &record = mRecords[index];
+    if ((uint64_t)record.plainOffset + record.length > mTextSize ||
+        (uint64_t)record.cipherOffset + record.length > mTextSize)
+    {
+        return false;
+    }
+    puzzle.plainText = string_view(mText + record.plainOffset, record.length);
+    puzzle.cipherText = string_view(mText + record.cipherOffset, record.length);
+    puzzle.cipher = record.cipher;
+    puzzle.key = record.key;
+    puzzle.difficulty = record.difficulty;
+    return true;
+}
+
+bool PuzzlePack::sample(uint32_t random, Puzzle &puzzle) const
+{
+    return mCount > 0 && get(random % mCount, puzzle);
+}
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef RIDDLEPACK_HPP
+#define RIDDLEPACK_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "contentStore.hpp"
+using namespace std;
+
+// Riddles and the decision tree that strings them together, loaded from
+// data instead of built by hand:
+//   textFiles/riddles.bin      riddle text, a content store converted from
+//                              riddles.txt; a riddle's id is its line number
+//   textFiles/riddle_tree.txt  the correct answers and the tree
+//
+// The tree is stored in heap order in one array. Answers are bits, 1 for a
+// correct answer, collected oldest first into a mask, so the node reached
+// after `count` answers is simply (2^count - 1) + mask: finding where the
+// player stands, or how the game ended, is a single array lookup. Riddle
+// text is read straight from the mapped store.
+enum RiddleOutcome
+{
+    RIDDLE_CONTINUE,
+    RIDDLE_WIN,
+    RIDDLE_LOSE
+};
+
+const int MAX_RIDDLE_DEPTH = 20;
+
+// Tree node values: a riddle id, or one of these.
+const int32_t NODE_WIN = -1;
+const int32_t NODE_LOSE = -2;
+const int32_t NODE_UNSET = -3;
+
+class RiddlePack
+{
+public:
+    RiddlePack();
+    bool load(const string &riddlesPath, const string &treePath);
+    int size() const;
+    string_view text() const;
+    size_t questionStart(int riddle) const;
+    size_t questionLength(int riddle) const;
+    bool answer(int riddle) const;
+    int depth() const;
+    static uint32_t nodeFor(uint32_t answers, int count);
+    int questionAt(uint32_t node) const;
+    RiddleOutcome outcomeAt(uint32_t node) const;
+
+private:
+    ContentStore mQuestions;
+    vector<unsigned char> mAnswers;
+    vector<int32_t> mNodes;
+    int mDepth;
+
+    bool loadTree(const string &path);
+    bool validate(const string &path) const;
+};
+
+RiddlePack::RiddlePack()
+{
+    mDepth = 0;
+}
+
+// Paths are read as answer bits ("-" for the first question) and each node
+// lands at its heap index; the array is sized once the deepest path is known.
+bool RiddlePack::loadTree(const string &path)
+{
+    ifstream file(path);
+    if (!file.is_open())
+    {
+        cout << "Unable to open file: " << path << endl;
+        return false;
+    }
+    struct Entry
+    {
+        uint32_t node;
+        int32_t value;
+        int line;
+    };
+    vector<Entry> entries;
+    string line;
+    int lineNumber = 0;
+    bool ok = true;
+    while (getline(file, line))
+    {
+        ++lineNumber;
+        istringstream in(line);
+        string command;
+        if (!(in >> command) || command[0] == '#')
+        {
+            continue;
+        }
+        if (command == "answer")
+        {
+            int riddle;
+            string value;
+            if (in >> riddle >> value && riddle >= 0 && riddle < size() && (value == "yes" || value == "no"))
+            {
+                mAnswers[riddle] = value == "yes";
+                continue;
+            }
+        }
+        else if (command == "node")
+        {
+            string bits, kind;
+            in >> bits >> kind;
+            uint32_t mask = 0;
+            int count = 0;
+            bool valid = !bits.empty();
+            if (bits != "-")
+            {
+                for (char c : bits)
+                {
+                    valid = valid && (c == '0' || c == '1') && count < MAX_RIDDLE_DEPTH;
+                    mask = (mask << 1) | (uint32_t)(c == '1');
+                    ++count;
+                }
+            }
+            int riddle = -1;
+            if (kind == "ask")
+            {
+                valid = valid && in >> riddle && riddle >= 0 && riddle < size();
+            }
+            else
+            {
+                valid = valid && (kind == "win" || kind == "lose");
+            }
+            if (valid)
+            {
+                int32_t value = kind == "ask" ? riddle : (kind == "win" ? NODE_WIN : NODE_LOSE);
+                entries.push_back({nodeFor(mask, count), value, lineNumber});
+                mDepth = max(mDepth, count);
+                continue;
+            }
+        }
+        cout << path << ":" << lineNumber << ": cannot read \"" << line << "\"" << endl;
+        ok = false;
+    }
+    if (!ok)
+    {
+        return false;
+    }
+
+    mNodes.assign(((size_t)2 << mDepth) - 1, NODE_UNSET);
+    for (const Entry &entry : entries)
+    {
+        if (mNodes[entry.node] != NODE_UNSET)
+        {
+            cout << path << ":" << entry.line << ": node given twice" << endl;
+            ok = false;
+        }
+        mNodes[entry.node] = entry.value;
+    }
+    return ok;
+}
+
+// Every question must have both outcomes defined and a known answer.
+bool RiddlePack::validate(const string &path) const
+{
+    if (mNodes.empty() || mNodes[0] == NODE_UNSET)
+    {
+        cout << path << ": the first question is missing" << endl;
+        return false;
+    }
+    for (size_t node = 0; node < mNodes.size(); ++node)
+    {
+        int32_t value = mNodes[node];
+        if (value < 0)
+        {
+            continue;
+        }
+        if (2 * node + 2 >= mNodes.size() || mNodes[2 * node + 1] == NODE_UNSET || mNodes[2 * node + 2] == NODE_UNSET)
+        {
+            cout << path << ": node " << node << " asks riddle " << value << " but does not say where both answers lead" << endl;
+            return false;
+        }
+        if (mAnswers[value] > 1)
+        {
+            cout << path << ": riddle " << value << " is asked but has no answer" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RiddlePack::load(const string &riddlesPath, const string &treePath)
+{
+    mNodes.clear();
+    mDepth = 0;
+    if (!mQuestions.open(riddlesPath, 1))
+    {
+        mAnswers.clear();
+        return false;
+    }
+    mAnswers.assign(size(), 2);
+    if (!loadTree(treePath) || !validate(treePath))
+    {
+        mNodes.clear();
+        return false;
+    }
+    return true;
+}
+
+int RiddlePack::size() const
+{
+    return (int)mQuestions.size();
+}
+
+string_view RiddlePack::text() const
+{
+    return mQuestions.text();
+}
+
+size_t RiddlePack::questionStart(int riddle) const
+{
+    return mQuestions.fieldOffset(riddle);
+}
+
+size_t RiddlePack::questionLength(int riddle) const
+{
+    return mQuestions.field(riddle).size();
+}
+
+bool RiddlePack::answer(int riddle) const
+{
+    return mAnswers[riddle] == 1;
+}
+
+int RiddlePack::depth() const
+{
+    return mDepth;
+}
+
+uint32_t RiddlePack::nodeFor(uint32_t answers, int count)
+{
+    return (((uint32_t)1 << count) - 1) + answers;
+}
+
+// Riddle asked at node, or -1 once the game is over there.
+int RiddlePack::questionAt(uint32_t node) const
+{
+    return node < mNodes.size() && mNodes[node] >= 0 ? mNodes[node] : -1;
+}
+
+// A node outside the tree (an empty or failed pack) counts as lost.
+RiddleOutcome RiddlePack::outcomeAt(uint32_t node) const
+{
+    if (node >= mNodes.size() || mNodes[node] == NODE_LOSE || mNodes[node] == NODE_UNSET)
+    {
+        return RIDDLE_LOSE;
+    }
+    return mNodes[node] == NODE_WIN ? RIDDLE_WIN : RIDDLE_CONTINUE;
+}
+
+#endif
@@ -3,19 +3,17 @@
 #include <SDL2/SDL_ttf.h>
 #include <iostream>
 #include <string>
-#include <fstream>
-#include <sstream>
-#include "DSA.hpp"
+#include <vector>
+#include "glyphCache.hpp"
+#include "riddlePack.hpp"
+#include "textLayout.hpp"
+#include "widgets.hpp"
 using namespace std;
 
 const int screenWIDTH = 900;
 const int screenHEIGHT = 700;
+const int RIDDLE_TEXT_WIDTH = 720;
 
-struct ridds
-{
-    string q[5];
-    bool a[5] = {0, 0, 1, 0, 1};
-};
 class RiddlesGame
 {
 public:
@@ -27,24 +25,46 @@ public:
 private:
     SDL_Renderer *renderer;
     SDL_Window *window;
-    TTF_Font *font, *font2;
-    ridds RD;
-    Node *root, *leftchild, *rightchild;
-    int currentRiddleIndex;
+    TTF_Font *font2;
+    bool ttfStarted;
+    RiddlePack pack;
+    // A riddle's page (background, text and answer labels) is composed into
+    // its own render target before it can come up: the first one when the
+    // scene starts, the next possible ones as soon as an answer is in.
+    GlyphCache glyphs;
+    vector<TextLayout> riddleLayouts;
+    vector<SDL_Texture *> pages;
+    bool renderTargets;
+    SDL_Texture *riddleBackground, *yesLabel, *noLabel;
+    SDL_Rect yesLabelRect, noLabelRect;
+    bool pagesDirty;
+    WidgetRegistry answerWidgets;
+    enum AnswerId
+    {
+        ANSWER_NO,
+        ANSWER_YES
+    };
+    uint32_t answers;
+    int answered;
     bool flag, ans, won=false;
     void Renderer();
     void renderText(SDL_Renderer *renderer, TTF_Font *font, const string &text, int x, int y, SDL_Color textColor);
     void renderStartScreen();
-    void renderRiddle(const string &riddle);
-    void renderButtons(SDL_Rect &yesButtonRect, SDL_Rect &noButtonRect);
+    SDL_Texture *createLabel(TTF_Font *font, const string &text, const SDL_Rect &buttonRect, SDL_Rect &labelRect);
+    void buildPages(const SDL_Rect &yesButtonRect, const SDL_Rect &noButtonRect);
+    void preparePage(int riddle);
+    void preparePagesFrom(uint32_t node);
+    void composePage(int riddle);
+    void composePages();
+    void destroyPages();
+    void renderRiddle(int riddle);
     void renderIntermediateScreen();
     void renderWinScreen();
     void renderLoseScreen();
     void clearRenderer();
     void clean();
-    void readRiddlesFromFile(const string &filename);
     void handleStartButtonClick();
-    void handleUserInput(SDL_Rect &yesButtonRect, SDL_Rect &noButtonRect);
+    void handleUserInput();
 };
 
 void RiddlesGame::Renderer()
@@ -54,7 +74,8 @@ void RiddlesGame::Renderer()
         cout << "SDL could not initialize! SDL_Error: " << SDL_GetError() << endl;
     }
 
-    if (TTF_Init() == -1)
+    ttfStarted = TTF_Init() == 0;
+    if (!ttfStarted)
     {
         cout << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << endl;
     }
@@ -71,9 +92,8 @@ void RiddlesGame::Renderer()
         cout << "Renderer could not be created! SDL_Error: " << SDL_GetError() << endl;
     }
 
-    font = TTF_OpenFont("Kanit-Medium.ttf", 24);
     font2 = TTF_OpenFont("JosefinSans-Bold.ttf", 50);
-    if (font == nullptr || font2 == nullptr)
+    if (font2 == nullptr || !glyphs.init(renderer, loadSdfFont("Kanit-Medium.ttf"), 24))
     {
         cout << "Unable to load font! SDL_ttf Error: " << TTF_GetError() << endl;
     }
@@ -83,12 +103,33 @@ RiddlesGame::~RiddlesGame()
 {
     clean();
 }
+// run() cleans up after a loss and the destructor always does, so a second
+// call finds everything nulled and only the first drops the SDL_ttf
+// reference.
 void RiddlesGame::clean()
 {
-    SDL_DestroyWindow(window);
-    SDL_DestroyRenderer(renderer);
-    TTF_CloseFont(font);
-    TTF_Quit();
+    destroyPages();
+    glyphs.free();
+    if (renderer != nullptr)
+    {
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    }
+    if (window != nullptr)
+    {
+        SDL_DestroyWindow(window);
+        window = nullptr;
+    }
+    if (font2 != nullptr)
+    {
+        TTF_CloseFont(font2);
+        font2 = nullptr;
+    }
+    if (ttfStarted)
+    {
+        TTF_Quit();
+        ttfStarted = false;
+    }
 }
 void RiddlesGame::renderText(SDL_Renderer *renderer, TTF_Font *font, const string &text, int x, int y, SDL_Color textColor)
 {
@@ -139,56 +180,156 @@ void RiddlesGame::renderStartScreen()
     }
     SDL_RenderPresent(renderer);
 }
-void RiddlesGame::renderRiddle(const string &riddle)
+SDL_Texture *RiddlesGame::createLabel(TTF_Font *font, const string &text, const SDL_Rect &buttonRect, SDL_Rect &labelRect)
 {
-    SDL_RenderClear(renderer);
+    SDL_Surface *textSurface = font == nullptr ? nullptr : TTF_RenderText_Solid(font, text.c_str(), {255, 255, 255, 255});
+    if (textSurface == nullptr)
+    {
+        cout << "Unable to render text surface! SDL_ttf Error: " << TTF_GetError() << endl;
+        labelRect = {0, 0, 0, 0};
+        return nullptr;
+    }
+    labelRect = {buttonRect.x + buttonRect.w / 2 - textSurface->w / 2, buttonRect.y + buttonRect.h / 2 - textSurface->h / 2,
+                 textSurface->w, textSurface->h};
+    SDL_Texture *label = SDL_CreateTextureFromSurface(renderer, textSurface);
+    SDL_FreeSurface(textSurface);
+    return label;
+}
 
-    SDL_Surface *backgroundSurface = IMG_Load("images/riddlescreen.jpg");
-    if (backgroundSurface == nullptr)
+// Loads the background and answer labels once and composes the first page.
+// Without render-target support pages stay null and renderRiddle() composes
+// straight to the screen from the cached pieces. Built with -DRIDDLES_DEBUG,
+// this and run() print the page build time and each riddle's show time.
+void RiddlesGame::buildPages(const SDL_Rect &yesButtonRect, const SDL_Rect &noButtonRect)
+{
+#ifdef RIDDLES_DEBUG
+    Uint64 start = SDL_GetPerformanceCounter();
+#endif
+    destroyPages();
+
+    riddleBackground = IMG_LoadTexture(renderer, "images/riddlescreen.jpg");
+    if (riddleBackground == nullptr)
     {
         cout << "Unable to load background image! SDL_image Error: " << IMG_GetError() << endl;
     }
-    else
+    TTF_Font *buttonFont = TTF_OpenFont("PirataOne-Regular.ttf", 70);
+    yesLabel = createLabel(buttonFont, "Yes", yesButtonRect, yesLabelRect);
+    noLabel = createLabel(buttonFont, "No", noButtonRect, noLabelRect);
+    TTF_CloseFont(buttonFont);
+
+    riddleLayouts.assign(pack.size(), TextLayout());
+    pages.assign(pack.size(), nullptr);
+    renderTargets = SDL_RenderTargetSupported(renderer);
+    preparePagesFrom(0);
+
+#ifdef RIDDLES_DEBUG
+    double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+    cout << "Riddle pages built in " << ms << " ms" << endl;
+#endif
+}
+
+// Lays the riddle out and, with render targets, composes its page. Each
+// riddle is prepared once however often it is asked.
+void RiddlesGame::preparePage(int riddle)
+{
+    if (riddle < 0 || !riddleLayouts[riddle].runs.empty() || pages[riddle] != nullptr)
     {
-        SDL_Texture *backgroundTexture = SDL_CreateTextureFromSurface(renderer, backgroundSurface);
-        SDL_FreeSurface(backgroundSurface);
+        return;
+    }
+    layoutText(glyphs, pack.text(), pack.questionStart(riddle), pack.questionLength(riddle), RIDDLE_TEXT_WIDTH,
+               riddleLayouts[riddle], BREAK_BALANCED, ALIGN_CENTER);
+    if (!renderTargets)
+    {
+        return;
+    }
+    pages[riddle] = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, screenWIDTH, screenHEIGHT);
+    if (pages[riddle] == nullptr)
+    {
+        cout << "Unable to create riddle page! SDL Error: " << SDL_GetError() << endl;
+        return;
+    }
+    SDL_SetRenderTarget(renderer, pages[riddle]);
+    composePage(riddle);
+    SDL_SetRenderTarget(renderer, nullptr);
+}
 
-        SDL_RenderCopy(renderer, backgroundTexture, nullptr, nullptr);
+// The riddle at node and the ones either answer leads to.
+void RiddlesGame::preparePagesFrom(uint32_t node)
+{
+    preparePage(pack.questionAt(node));
+    preparePage(pack.questionAt(2 * node + 1));
+    preparePage(pack.questionAt(2 * node + 2));
+}
 
-        stringstream ss(riddle);
-        string line;
-        int y = 200;
-        int maxWidth = screenWIDTH - 40;
+void RiddlesGame::composePage(int riddle)
+{
+    SDL_RenderClear(renderer);
+    if (riddleBackground != nullptr)
+    {
+        SDL_RenderCopy(renderer, riddleBackground, nullptr, nullptr);
+    }
+    drawLayout(glyphs, pack.text(), riddleLayouts[riddle], (screenWIDTH - RIDDLE_TEXT_WIDTH) / 2, 185, {255, 255, 255, 255});
+    if (yesLabel != nullptr)
+    {
+        SDL_RenderCopy(renderer, yesLabel, nullptr, &yesLabelRect);
+    }
+    if (noLabel != nullptr)
+    {
+        SDL_RenderCopy(renderer, noLabel, nullptr, &noLabelRect);
+    }
+}
 
-        while (getline(ss, line, '\n'))
+// Refills the pages after the driver drops render-target contents
+// (SDL_RENDER_TARGETS_RESET).
+void RiddlesGame::composePages()
+{
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        if (pages[i] != nullptr)
         {
-            size_t startPos = 0;
-            while (startPos < line.length())
-            {
-                size_t spacePos = line.find("  ", startPos);
-                if (spacePos == string::npos)
-                    spacePos = line.length();
-
-                string subLine = line.substr(startPos, spacePos - startPos);
-
-                renderText(renderer, font, subLine, screenWIDTH / 2, y, {255, 255, 255, 255});
-
-                y += 30;
-                startPos = spacePos + 1;
-            }
+            SDL_SetRenderTarget(renderer, pages[i]);
+            composePage((int)i);
         }
-
-        SDL_DestroyTexture(backgroundTexture);
     }
+    SDL_SetRenderTarget(renderer, nullptr);
+    pagesDirty = false;
 }
-void RiddlesGame::renderButtons(SDL_Rect &yesButtonRect, SDL_Rect &noButtonRect)
-{
-    TTF_Font *font = TTF_OpenFont("PirataOne-Regular.ttf", 70);
-    renderText(renderer, font, "Yes", yesButtonRect.x + yesButtonRect.w / 2, yesButtonRect.y + yesButtonRect.h / 2, {255, 255, 255, 255});
 
-    renderText(renderer, font, "No", noButtonRect.x + noButtonRect.w / 2, noButtonRect.y + noButtonRect.h / 2, {255, 255, 255, 255});
+void RiddlesGame::destroyPages()
+{
+    for (SDL_Texture *&page : pages)
+    {
+        if (page != nullptr)
+        {
+            SDL_DestroyTexture(page);
+            page = nullptr;
+        }
+    }
+    SDL_Texture **pieces[] = {&riddleBackground, &yesLabel, &noLabel};
+    for (SDL_Texture **piece : pieces)
+    {
+        if (*piece != nullptr)
+        {
+            SDL_DestroyTexture(*piece);
+            *piece = nullptr;
+        }
+    }
+}
 
-    SDL_RenderPresent(renderer);
+void RiddlesGame::renderRiddle(int riddle)
+{
+    if (pagesDirty)
+    {
+        composePages();
+    }
+    if (pages[riddle] != nullptr)
+    {
+        SDL_RenderCopy(renderer, pages[riddle], nullptr, nullptr);
+    }
+    else
+    {
+        composePage(riddle);
+    }
 }
 
 void RiddlesGame::renderIntermediateScreen()
@@ -268,24 +409,15 @@ void RiddlesGame::clearRenderer()
     SDL_RenderClear(renderer);
 }
 
-RiddlesGame::RiddlesGame() : currentRiddleIndex(0)
+RiddlesGame::RiddlesGame()
+    : renderTargets(false), riddleBackground(nullptr), yesLabel(nullptr), noLabel(nullptr), pagesDirty(false),
+      answerWidgets(screenWIDTH, screenHEIGHT), answers(0), answered(0)
 {
     Renderer();
-    readRiddlesFromFile("textFiles/riddles.txt");
-
-    root = newNode(5);
-    root->left = newNode(3);
-    root->left->right = newNode(4);
-    root->left->left = newNode(2);
-    root->left->left->left = newNode(1);
-    root->left->left->right = newNode(0);
-    root->right = newNode(9);
-    root->right->left = newNode(7);
-    root->right->right = newNode(10);
-    root->right->right->right = newNode(12);
-    root->right->right->left = newNode(11);
-    leftchild = root->left;
-    rightchild = root->right;
+    if (!pack.load("textFiles/riddles.bin", "textFiles/riddle_tree.txt"))
+    {
+        cout << "Unable to load the riddle pack" << endl;
+    }
 }
 
 void RiddlesGame::run()
@@ -317,60 +449,49 @@ void RiddlesGame::run()
     SDL_Rect buttonsRect = {screenWIDTH / 2 - 100, screenHEIGHT / 2 + 150, 250, 50};
     SDL_Rect yesButtonRect = {buttonsRect.x, buttonsRect.y, 100, 50};
     SDL_Rect noButtonRect = {buttonsRect.x + 150, buttonsRect.y, 100, 50};
+    answerWidgets.clear();
+    answerWidgets.add(ANSWER_YES, yesButtonRect);
+    answerWidgets.add(ANSWER_NO, noButtonRect);
+    buildPages(yesButtonRect, noButtonRect);
 
-    while (currentRiddleIndex < 5)
+    uint32_t node = 0;
+    while (pack.outcomeAt(node) == RIDDLE_CONTINUE)
     {
-        renderRiddle(RD.q[currentRiddleIndex]);
-        renderButtons(yesButtonRect, noButtonRect);
-        handleUserInput(yesButtonRect, noButtonRect);
+        int riddle = pack.questionAt(node);
+#ifdef RIDDLES_DEBUG
+        Uint64 shown = SDL_GetPerformanceCounter();
+#endif
+        renderRiddle(riddle);
+        SDL_RenderPresent(renderer);
+#ifdef RIDDLES_DEBUG
+        double ms = (SDL_GetPerformanceCounter() - shown) * 1000.0 / SDL_GetPerformanceFrequency();
+        cout << "Riddle " << riddle + 1 << " shown in " << ms << " ms" << endl;
+#endif
+        handleUserInput();
         SDL_Delay(700);
 
-        if (ans == RD.a[currentRiddleIndex])
-        {
-            if (root->right != NULL)
-            {
-                root = rightchild;
-                rightchild = root->right;
-                cout << "AT node: " << root->data << endl;
-                renderText(renderer, font2, "Correct", screenWIDTH / 2, screenHEIGHT / 2 + 300, {255, 255, 255, 255});
-                currentRiddleIndex++;
-            }
-            else
-            {
-                break;
-            }
-        }
-        else
-        {
-            if (root->left != NULL)
-            {
-                root = leftchild;
-                leftchild = root->left;
-                cout << "AT node: " << root->data << endl;
-                renderText(renderer, font2, "Incorrect", screenWIDTH / 2, screenHEIGHT / 2 + 300, {255, 255, 255, 255});
-                currentRiddleIndex++;
-            }
-            else
-            {
-                break;
-            }
-        }
-
+        bool correct = ans == pack.answer(riddle);
+        answers = (answers << 1) | (uint32_t)correct;
+        answered++;
+        node = RiddlePack::nodeFor(answers, answered);
+        cout << "AT node: " << node << endl;
+        renderText(renderer, font2, correct ? "Correct" : "Incorrect", screenWIDTH / 2, screenHEIGHT / 2 + 300, {255, 255, 255, 255});
         SDL_RenderPresent(renderer);
+        preparePagesFrom(node);
         SDL_Delay(500);
     }
 
-    if (root->data == 12)
+    if (pack.outcomeAt(node) == RIDDLE_WIN)
     {
         cout << "YOU WON" << endl;
-        cout << root->data << endl;
+        cout << node << endl;
         renderWinScreen();
         won = true;
     }
     else
     {
         cout << "You Lost" << endl;
-        cout << root->data << endl;
+        cout << node << endl;
         renderLoseScreen();
        
         clean();
@@ -379,29 +500,7 @@ void RiddlesGame::run()
 bool RiddlesGame::isWin(){
     return won;
 }
-void RiddlesGame::readRiddlesFromFile(const string &filename)
-{
-    ifstream file(filename);
-
-    if (!file.is_open())
-    {
-        cout << "Unable to open file: " << filename << endl;
-        return;
-    }
-
-    for (int i = 0; i < 5; ++i)
-    {
-        if (!getline(file, RD.q[i]))
-        {
-            cout << "Error reading riddle from file: " << filename << endl;
-            break;
-        }
-    }
-
-    file.close();
-}
-
-void RiddlesGame::handleUserInput(SDL_Rect &yesButtonRect, SDL_Rect &noButtonRect)
+void RiddlesGame::handleUserInput()
 {
     SDL_Event e;
     bool userInputEntered = false;
@@ -410,22 +509,22 @@ void RiddlesGame::handleUserInput(SDL_Rect &yesButtonRect, SDL_Rect &noButtonRec
     {
         if (SDL_PollEvent(&e) != 0)
         {
+            if (e.type == SDL_RENDER_TARGETS_RESET)
+            {
+                pagesDirty = true;
+            }
+            int clicked = answerWidgets.handleEvent(e);
             if (e.type == SDL_MOUSEBUTTONDOWN)
             {
-                int mouseX, mouseY;
-                SDL_GetMouseState(&mouseX, &mouseY);
-
-                cout << "Mouse clicked at: (" << mouseX << ", " << mouseY << ")" << endl;
+                cout << "Mouse clicked at: (" << e.button.x << ", " << e.button.y << ")" << endl;
 
-                if (mouseX >= yesButtonRect.x && mouseX <= yesButtonRect.x + yesButtonRect.w &&
-                    mouseY >= yesButtonRect.y && mouseY <= yesButtonRect.y + yesButtonRect.h)
+                if (clicked == ANSWER_YES)
                 {
                     cout << "Clicked Yes button" << endl;
                     flag = true;
                     userInputEntered = true;
                 }
-                else if (mouseX >= noButtonRect.x && mouseX <= noButtonRect.x + noButtonRect.w &&
-                         mouseY >= noButtonRect.y && mouseY <= noButtonRect.y + noButtonRect.h)
+                else if (clicked == ANSWER_NO)
                 {
                     cout << "Clicked No button" << endl;
                     flag = false;
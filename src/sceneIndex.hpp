@@ -0,0 +1,132 @@
+#ifndef SCENEINDEX_HPP
+#define SCENEINDEX_HPP
+
+#include <algorithm>
+#include <vector>
+#include <SDL2/SDL_rect.h>
+#include "spatialGrid.hpp"
+using namespace std;
+
+// Spatial index over the object rects of a scene. Objects are numbered in
+// draw order (0 is drawn first), so the topmost object under a point is the
+// highest-numbered hit. Clicks look at one grid cell and the visible set of a
+// camera rect only at the cells it covers, so both stay flat as the scene
+// grows.
+class SceneIndex
+{
+public:
+    SceneIndex(int width = 0, int height = 0, int cellSize = 64);
+    void reset(int width, int height, int cellSize = 64);
+    int add(const SDL_Rect &rect);
+    void hide(int index);
+    bool isHidden(int index) const;
+    int size() const;
+    int topmostAt(int x, int y) const;
+    template <typename Accept>
+    int topmostAt(int x, int y, Accept accept) const;
+    void visibleIn(const SDL_Rect &camera, vector<int> &indices) const;
+
+private:
+    SpatialGrid mGrid;
+    vector<SDL_Rect> mRects;
+    vector<bool> mHidden;
+    mutable vector<int> mCandidates;
+    mutable vector<unsigned> mSeen;
+    mutable unsigned mQuery;
+};
+
+SceneIndex::SceneIndex(int width, int height, int cellSize)
+    : mGrid(width, height, cellSize), mQuery(0)
+{
+}
+
+void SceneIndex::reset(int width, int height, int cellSize)
+{
+    mGrid.reset(width, height, cellSize);
+    mRects.clear();
+    mHidden.clear();
+    mSeen.clear();
+    mQuery = 0;
+}
+
+int SceneIndex::add(const SDL_Rect &rect)
+{
+    int index = (int)mRects.size();
+    mRects.push_back(rect);
+    mHidden.push_back(false);
+    mSeen.push_back(0);
+    mGrid.insert(index, rect);
+    return index;
+}
+
+// Hidden objects leave the grid, so later queries do not even see them.
+void SceneIndex::hide(int index)
+{
+    if (index < 0 || index >= (int)mRects.size() || mHidden[index])
+    {
+        return;
+    }
+    mHidden[index] = true;
+    mGrid.remove(index, mRects[index]);
+}
+
+bool SceneIndex::isHidden(int index) const
+{
+    return mHidden[index];
+}
+
+int SceneIndex::size() const
+{
+    return (int)mRects.size();
+}
+
+// Returns the index of the topmost visible object containing the point, or -1.
+int SceneIndex::topmostAt(int x, int y) const
+{
+    return topmostAt(x, y, [](int) { return true; });
+}
+
+// Same, but an object whose rect contains the point only counts when
+// accept(index) agrees, e.g. after a per-pixel test. Rejected objects let
+// the click fall through to the ones below.
+template <typename Accept>
+int SceneIndex::topmostAt(int x, int y, Accept accept) const
+{
+    int topmost = -1;
+    for (int index : mGrid.candidatesAt(x, y))
+    {
+        const SDL_Rect &rect = mRects[index];
+        if (index > topmost && x >= rect.x && x <= rect.x + rect.w && y >= rect.y && y <= rect.y + rect.h &&
+            accept(index))
+        {
+            topmost = index;
+        }
+    }
+    return topmost;
+}
+
+// Fills indices with the visible objects overlapping the camera rect, each
+// once, in the order they were added.
+void SceneIndex::visibleIn(const SDL_Rect &camera, vector<int> &indices) const
+{
+    mGrid.queryRect(camera, mCandidates);
+    if (++mQuery == 0)
+    {
+        mSeen.assign(mSeen.size(), 0);
+        mQuery = 1;
+    }
+    indices.clear();
+    for (int index : mCandidates)
+    {
+        const SDL_Rect &rect = mRects[index];
+        if (mSeen[index] != mQuery && rect.x < camera.x + camera.w && rect.x + rect.w > camera.x &&
+            rect.y < camera.y + camera.h && rect.y + rect.h > camera.y)
+        {
+            mSeen[index] = mQuery;
+            indices.push_back(index);
+        }
+    }
+    sort(indices.begin(), indices.end());
+}
+
+#endif
@@ -0,0 +1,455 @@
+#ifndef SDFFONT_HPP
+#define SDFFONT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include "skylinePacker.hpp"
+using namespace std;
+
+// Signed distance field of the printable ASCII glyphs of one font file, made
+// once from a supersampled FreeType rendering and cached on disk, so any
+// point size can be produced from it without opening the font again.
+// Cache layout (little-endian, in textFiles/<font file>.sdf):
+//   SdfFontHeader
+//   SdfGlyph glyphs[glyphCount]
+//   float kerning[glyphCount * glyphCount]     base pixels, previous-major
+//   uint8_t field[atlasWidth * atlasHeight]    0.5 (128) on the outline
+// All metrics are in pixels of an SDF_BASE_SIZE point font. A field value
+// of 1 is SDF_SPREAD pixels inside the outline, 0 is SDF_SPREAD outside.
+// The cache is rebuilt when the font file changes size.
+struct SdfFontHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    uint32_t glyphCount;
+    uint32_t atlasWidth;
+    uint32_t atlasHeight;
+    float lineHeight;
+};
+
+// One glyph box as the font renders it: pen position to advance wide and a
+// full line high. Its field cell adds SDF_SPREAD pixels on every side.
+struct SdfGlyph
+{
+    uint16_t x, y;
+    uint16_t cellWidth, cellHeight;
+    float width, height;
+    float advance;
+};
+
+const char SDF_FONT_MAGIC[4] = {'E', 'R', 'S', 'D'};
+const uint32_t SDF_FONT_VERSION = 1;
+const int SDF_FIRST_GLYPH = 32;
+const int SDF_GLYPH_COUNT = 95;
+const int SDF_BASE_SIZE = 48;
+const int SDF_SPREAD = 6;
+const int SDF_SUPERSAMPLE = 4;
+
+class SdfFont
+{
+public:
+    SdfFont();
+    bool load(const string &fontPath, const string &cachePath);
+    bool isLoaded() const;
+    float scaleFor(int pointSize) const;
+    float lineHeight() const;
+    float advance(int index) const;
+    float kerning(int previous, int index) const;
+    SDL_Surface *renderGlyph(int index, float scale) const;
+
+private:
+    SdfFontHeader mHeader;
+    vector<SdfGlyph> mGlyphs;
+    vector<float> mKerning;
+    vector<uint8_t> mField;
+    bool mLoaded;
+
+    bool readCache(const string &path, uint64_t sourceSize);
+    bool writeCache(const string &path) const;
+    bool generate(const string &fontPath, uint64_t sourceSize);
+    float sample(const SdfGlyph &glyph, float u, float v) const;
+};
+
+SdfFont::SdfFont()
+{
+    memset(&mHeader, 0, sizeof(mHeader));
+    mLoaded = false;
+}
+
+bool SdfFont::load(const string &fontPath, const string &cachePath)
+{
+    ifstream source(fontPath, ios::binary | ios::ate);
+    if (!source)
+    {
+        cout << "Unable to open font " << fontPath << "!" << endl;
+        return false;
+    }
+    uint64_t sourceSize = (uint64_t)source.tellg();
+    source.close();
+
+    mLoaded = readCache(cachePath, sourceSize);
+    if (!mLoaded)
+    {
+        mLoaded = generate(fontPath, sourceSize);
+        if (mLoaded && !writeCache(cachePath))
+        {
+            cout << "Unable to write distance field cache " << cachePath << "!" << endl;
+        }
+    }
+    return mLoaded;
+}
+
+bool SdfFont::isLoaded() const
+{
+    return mLoaded;
+}
+
+float SdfFont::scaleFor(int pointSize) const
+{
+    return (float)pointSize / SDF_BASE_SIZE;
+}
+
+float SdfFont::lineHeight() const
+{
+    return mHeader.lineHeight;
+}
+
+float SdfFont::advance(int index) const
+{
+    return mGlyphs[index].advance;
+}
+
+float SdfFont::kerning(int previous, int index) const
+{
+    return mKerning[previous * SDF_GLYPH_COUNT + index];
+}
+
+bool SdfFont::readCache(const string &path, uint64_t sourceSize)
+{
+    ifstream file(path, ios::binary);
+    if (!file || !file.read((char *)&mHeader, sizeof(mHeader)))
+    {
+        return false;
+    }
+    if (memcmp(mHeader.magic, SDF_FONT_MAGIC, 4) != 0 || mHeader.version != SDF_FONT_VERSION ||
+        mHeader.sourceSize != sourceSize || mHeader.glyphCount != SDF_GLYPH_COUNT ||
+        mHeader.atlasWidth > 4096 || mHeader.atlasHeight > 4096)
+    {
+        return false;
+    }
+    mGlyphs.resize(SDF_GLYPH_COUNT);
+    mKerning.resize(SDF_GLYPH_COUNT * SDF_GLYPH_COUNT);
+    mField.resize((size_t)mHeader.atlasWidth * mHeader.atlasHeight);
+    file.read((char *)mGlyphs.data(), mGlyphs.size() * sizeof(SdfGlyph));
+    file.read((char *)mKerning.data(), mKerning.size() * sizeof(float));
+    file.read((char *)mField.data(), mField.size());
+    if (!file)
+    {
+        cout << "Distance field cache " << path << " is truncated!" << endl;
+        return false;
+    }
+    for (const SdfGlyph &glyph : mGlyphs)
+    {
+        if (glyph.x + glyph.cellWidth > mHeader.atlasWidth || glyph.y + glyph.cellHeight > mHeader.atlasHeight)
+        {
+            cout << "Distance field cache " << path << " is corrupt!" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SdfFont::writeCache(const string &path) const
+{
+    ofstream out(path, ios::binary);
+    out.write((const char *)&mHeader, sizeof(mHeader));
+    out.write((const char *)mGlyphs.data(), mGlyphs.size() * sizeof(SdfGlyph));
+    out.write((const char *)mKerning.data(), mKerning.size() * sizeof(float));
+    out.write((const char *)mField.data(), mField.size());
+    return (bool)out;
+}
+
+// Eight-point sequential Euclidean distance transform: afterwards every
+// pixel holds the offset to its nearest seed pixel.
+void nearestSeed(const vector<uint8_t> &seed, int width, int height, vector<float> &distance)
+{
+    const int FAR = 1 << 14;
+    vector<int> dx(seed.size()), dy(seed.size());
+    for (size_t p = 0; p < seed.size(); ++p)
+    {
+        dx[p] = seed[p] ? 0 : FAR;
+        dy[p] = seed[p] ? 0 : FAR;
+    }
+    auto compare = [&](int x, int y, int ox, int oy) {
+        int nx = x + ox, ny = y + oy;
+        if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+        {
+            return;
+        }
+        int p = y * width + x, q = ny * width + nx;
+        int cx = dx[q] + ox, cy = dy[q] + oy;
+        if ((long)cx * cx + (long)cy * cy < (long)dx[p] * dx[p] + (long)dy[p] * dy[p])
+        {
+            dx[p] = cx;
+            dy[p] = cy;
+        }
+    };
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            compare(x, y, -1, 0);
+            compare(x, y, 0, -1);
+            compare(x, y, -1, -1);
+            compare(x, y, 1, -1);
+        }
+        for (int x = width - 1; x >= 0; --x)
+        {
+            compare(x, y, 1, 0);
+        }
+    }
+    for (int y = height - 1; y >= 0; --y)
+    {
+        for (int x = width - 1; x >= 0; --x)
+        {
+            compare(x, y, 1, 0);
+            compare(x, y, 0, 1);
+            compare(x, y, -1, 1);
+            compare(x, y, 1, 1);
+        }
+        for (int x = 0; x < width; ++x)
+        {
+            compare(x, y, -1, 0);
+        }
+    }
+    distance.resize(seed.size());
+    for (size_t p = 0; p < seed.size(); ++p)
+    {
+        distance[p] = sqrtf((float)dx[p] * dx[p] + (float)dy[p] * dy[p]);
+    }
+}
+
+// Renders the font at SDF_SUPERSAMPLE times the base size, takes the signed
+// distance of every high-resolution pixel to the outline and averages it
+// down to one field value per base pixel. Runs only when there is no usable
+// cache, so SDL_ttf must be initialised then.
+bool SdfFont::generate(const string &fontPath, uint64_t sourceSize)
+{
+    const int S = SDF_SUPERSAMPLE;
+    const int PAD = SDF_SPREAD * S;
+    TTF_Font *font = TTF_OpenFont(fontPath.c_str(), SDF_BASE_SIZE * S);
+    if (font == NULL)
+    {
+        cout << "Failed to load font! SDL_ttf Error: " << TTF_GetError() << endl;
+        return false;
+    }
+
+    memcpy(mHeader.magic, SDF_FONT_MAGIC, 4);
+    mHeader.version = SDF_FONT_VERSION;
+    mHeader.sourceSize = sourceSize;
+    mHeader.glyphCount = SDF_GLYPH_COUNT;
+    mHeader.lineHeight = (float)TTF_FontHeight(font) / S;
+    mGlyphs.assign(SDF_GLYPH_COUNT, SdfGlyph());
+    mKerning.assign(SDF_GLYPH_COUNT * SDF_GLYPH_COUNT, 0.0f);
+    vector<vector<uint8_t>> cells(SDF_GLYPH_COUNT);
+
+    for (int i = 0; i < SDF_GLYPH_COUNT; ++i)
+    {
+        char c = (char)(SDF_FIRST_GLYPH + i);
+        SdfGlyph &glyph = mGlyphs[i];
+        glyph = {0, 0, 0, 0, 0.0f, 0.0f, 0.0f};
+        int minX, maxX, minY, maxY, advance;
+        if (TTF_GlyphMetrics32(font, (Uint32)c, &minX, &maxX, &minY, &maxY, &advance) == 0)
+        {
+            glyph.advance = (float)advance / S;
+        }
+        for (int j = 0; j < SDF_GLYPH_COUNT; ++j)
+        {
+            mKerning[i * SDF_GLYPH_COUNT + j] = (float)TTF_GetFontKerningSizeGlyphs32(font, (Uint32)c, (Uint32)(SDF_FIRST_GLYPH + j)) / S;
+        }
+        if (c == ' ')
+        {
+            continue;
+        }
+        char text[2] = {c, '\0'};
+        SDL_Surface *rendered = TTF_RenderText_Blended(font, text, {255, 255, 255, 255});
+        SDL_Surface *bitmap = rendered ? SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0) : NULL;
+        SDL_FreeSurface(rendered);
+        if (bitmap == NULL)
+        {
+            continue;
+        }
+
+        // Padded out to whole base pixels so every field value averages a
+        // full S x S block.
+        int width = (bitmap->w + 2 * PAD + S - 1) / S * S;
+        int height = (bitmap->h + 2 * PAD + S - 1) / S * S;
+        vector<uint8_t> inside(width * height, 0), outside(width * height, 1);
+        for (int y = 0; y < bitmap->h; ++y)
+        {
+            const Uint32 *row = (const Uint32 *)((const Uint8 *)bitmap->pixels + y * bitmap->pitch);
+            for (int x = 0; x < bitmap->w; ++x)
+            {
+                bool covered = (row[x] >> 24) >= 128;
+                inside[(y + PAD) * width + x + PAD] = covered;
+                outside[(y + PAD) * width + x + PAD] = !covered;
+            }
+        }
+        glyph.width = (float)bitmap->w / S;
+        glyph.height = (float)bitmap->h / S;
+        SDL_FreeSurface(bitmap);
+
+        vector<float> toInside, toOutside;
+        nearestSeed(inside, width, height, toInside);
+        nearestSeed(outside, width, height, toOutside);
+
+        // The outline runs half a pixel from the centres on either side of it.
+        glyph.cellWidth = (uint16_t)(width / S);
+        glyph.cellHeight = (uint16_t)(height / S);
+        vector<uint8_t> &cell = cells[i];
+        cell.resize(glyph.cellWidth * glyph.cellHeight);
+        for (int cy = 0; cy < glyph.cellHeight; ++cy)
+        {
+            for (int cx = 0; cx < glyph.cellWidth; ++cx)
+            {
+                float sum = 0.0f;
+                for (int y = cy * S; y < cy * S + S; ++y)
+                {
+                    for (int x = cx * S; x < cx * S + S; ++x)
+                    {
+                        int p = y * width + x;
+                        sum += inside[p] ? toOutside[p] - 0.5f : 0.5f - toInside[p];
+                    }
+                }
+                float value = 0.5f + sum / (S * S) / S / (2.0f * SDF_SPREAD);
+                cell[cy * glyph.cellWidth + cx] = (uint8_t)lroundf(255.0f * fminf(1.0f, fmaxf(0.0f, value)));
+            }
+        }
+    }
+    TTF_CloseFont(font);
+
+    int order[SDF_GLYPH_COUNT];
+    for (int i = 0; i < SDF_GLYPH_COUNT; ++i)
+    {
+        order[i] = i;
+    }
+    sort(order, order + SDF_GLYPH_COUNT, [&](int a, int b) {
+        return mGlyphs[a].cellHeight > mGlyphs[b].cellHeight;
+    });
+    SkylinePacker packer;
+    int side = 128;
+    bool packed = false;
+    while (!packed && side <= 4096)
+    {
+        packer.reset(side, side, 1);
+        packed = true;
+        for (int i : order)
+        {
+            SDL_Rect rect = {0, 0, 0, 0};
+            if (mGlyphs[i].cellWidth > 0 && !packer.insert(mGlyphs[i].cellWidth, mGlyphs[i].cellHeight, rect))
+            {
+                packed = false;
+                side *= 2;
+                break;
+            }
+            mGlyphs[i].x = (uint16_t)rect.x;
+            mGlyphs[i].y = (uint16_t)rect.y;
+        }
+    }
+    if (!packed)
+    {
+        cout << "Distance field atlas for " << fontPath << " does not fit!" << endl;
+        return false;
+    }
+
+    mHeader.atlasWidth = (uint32_t)side;
+    mHeader.atlasHeight = (uint32_t)max(1, packer.getUsedHeight());
+    mField.assign((size_t)mHeader.atlasWidth * mHeader.atlasHeight, 0);
+    for (int i = 0; i < SDF_GLYPH_COUNT; ++i)
+    {
+        const SdfGlyph &glyph = mGlyphs[i];
+        for (int y = 0; y < glyph.cellHeight; ++y)
+        {
+            memcpy(&mField[(glyph.y + y) * mHeader.atlasWidth + glyph.x], &cells[i][y * glyph.cellWidth], glyph.cellWidth);
+        }
+    }
+    return true;
+}
+
+// Bilinear field value at (u, v) in base pixels from the glyph box origin,
+// clamped to the glyph's own cell.
+float SdfFont::sample(const SdfGlyph &glyph, float u, float v) const
+{
+    float fx = fminf(fmaxf(u + SDF_SPREAD - 0.5f, 0.0f), glyph.cellWidth - 1.0f);
+    float fy = fminf(fmaxf(v + SDF_SPREAD - 0.5f, 0.0f), glyph.cellHeight - 1.0f);
+    int x0 = (int)fx, y0 = (int)fy;
+    int x1 = min(x0 + 1, glyph.cellWidth - 1), y1 = min(y0 + 1, glyph.cellHeight - 1);
+    float tx = fx - x0, ty = fy - y0;
+    const uint8_t *row0 = &mField[(glyph.y + y0) * mHeader.atlasWidth + glyph.x];
+    const uint8_t *row1 = &mField[(glyph.y + y1) * mHeader.atlasWidth + glyph.x];
+    float top = row0[x0] + (row0[x1] - row0[x0]) * tx;
+    float bottom = row1[x0] + (row1[x1] - row1[x0]) * tx;
+    return (top + (bottom - top) * ty) / 255.0f;
+}
+
+// White glyph bitmap at the given scale, laid out like a TTF_RenderText
+// bitmap of that size. SDL_Renderer has no shaders, so the alpha threshold
+// is taken here, once per size: coverage ramps from 0 to 1 across one output
+// pixel around the outline. NULL for glyphs without an outline.
+SDL_Surface *SdfFont::renderGlyph(int index, float scale) const
+{
+    const SdfGlyph &glyph = mGlyphs[index];
+    int width = (int)lroundf(glyph.width * scale);
+    int height = (int)lroundf(glyph.height * scale);
+    if (glyph.cellWidth == 0 || width <= 0 || height <= 0)
+    {
+        return NULL;
+    }
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (surface == NULL)
+    {
+        return NULL;
+    }
+    float halfWidth = 1.0f / (4.0f * SDF_SPREAD * scale);
+    for (int y = 0; y < height; ++y)
+    {
+        Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+        for (int x = 0; x < width; ++x)
+        {
+            float value = sample(glyph, (x + 0.5f) / scale, (y + 0.5f) / scale);
+            float coverage = fminf(1.0f, fmaxf(0.0f, (value - 0.5f + halfWidth) / (2.0f * halfWidth)));
+            row[x] = ((Uint32)lroundf(coverage * 255.0f) << 24) | 0x00FFFFFF;
+        }
+    }
+    return surface;
+}
+
+// Fields are plain memory, not textures, so one per font file serves every
+// screen and renderer. The cache file sits in textFiles/ next to the other
+// generated data. Fonts that fail to load are remembered as failures.
+const SdfFont *loadSdfFont(const string &fontPath)
+{
+    static unordered_map<string, unique_ptr<SdfFont>> fonts;
+    unique_ptr<SdfFont> &font = fonts[fontPath];
+    if (!font)
+    {
+        size_t slash = fontPath.find_last_of("/\\");
+        string name = slash == string::npos ? fontPath : fontPath.substr(slash + 1);
+        font.reset(new SdfFont());
+        font->load(fontPath, "textFiles/" + name + ".sdf");
+    }
+    return font->isLoaded() ? font.get() : NULL;
+}
+
+#endif
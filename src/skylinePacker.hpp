@@ -0,0 +1,134 @@
+#ifndef SKYLINEPACKER_HPP
+#define SKYLINEPACKER_HPP
+
+#include <vector>
+#include <SDL2/SDL_rect.h>
+using namespace std;
+
+// Packs rectangles into a fixed page with the skyline bottom-left rule: the
+// top edge of everything placed so far is kept as a list of horizontal
+// segments, and each new rect goes where it ends up lowest (leftmost on
+// ties). Good enough for a few dozen sprites and fast for thousands.
+class SkylinePacker
+{
+public:
+    SkylinePacker(int width = 0, int height = 0, int padding = 1);
+    void reset(int width, int height, int padding);
+    bool insert(int width, int height, SDL_Rect &rect);
+    int getUsedHeight() const;
+
+private:
+    struct Segment
+    {
+        int x, y, width;
+    };
+
+    int mWidth, mHeight, mPadding, mUsedHeight;
+    vector<Segment> mSkyline;
+
+    int fitAt(size_t index, int width, int height) const;
+};
+
+SkylinePacker::SkylinePacker(int width, int height, int padding)
+{
+    reset(width, height, padding);
+}
+
+void SkylinePacker::reset(int width, int height, int padding)
+{
+    mWidth = width;
+    mHeight = height;
+    mPadding = padding;
+    mUsedHeight = 0;
+    mSkyline.assign(1, {0, 0, width});
+}
+
+// Returns the y a rect would rest at when its left edge is on segment
+// index, or -1 if it does not fit there.
+int SkylinePacker::fitAt(size_t index, int width, int height) const
+{
+    int x = mSkyline[index].x;
+    if (x + width > mWidth)
+    {
+        return -1;
+    }
+    int y = 0;
+    int remaining = width;
+    for (size_t i = index; remaining > 0 && i < mSkyline.size(); ++i)
+    {
+        y = max(y, mSkyline[i].y);
+        if (y + height > mHeight)
+        {
+            return -1;
+        }
+        remaining -= mSkyline[i].width;
+    }
+    return y;
+}
+
+bool SkylinePacker::insert(int width, int height, SDL_Rect &rect)
+{
+    int paddedWidth = width + mPadding;
+    int paddedHeight = height + mPadding;
+    int bestY = -1;
+    size_t bestIndex = 0;
+    for (size_t i = 0; i < mSkyline.size(); ++i)
+    {
+        int y = fitAt(i, paddedWidth, paddedHeight);
+        if (y >= 0 && (bestY < 0 || y < bestY))
+        {
+            bestY = y;
+            bestIndex = i;
+        }
+    }
+    if (bestY < 0)
+    {
+        return false;
+    }
+
+    rect = {mSkyline[bestIndex].x, bestY, width, height};
+    mUsedHeight = max(mUsedHeight, bestY + paddedHeight);
+
+    // The new segment covers the rect's width; segments it overlaps are
+    // shortened or dropped.
+    Segment added = {rect.x, bestY + paddedHeight, paddedWidth};
+    mSkyline.insert(mSkyline.begin() + bestIndex, added);
+    int right = added.x + added.width;
+    size_t i = bestIndex + 1;
+    while (i < mSkyline.size() && mSkyline[i].x < right)
+    {
+        int overlap = right - mSkyline[i].x;
+        if (overlap >= mSkyline[i].width)
+        {
+            mSkyline.erase(mSkyline.begin() + i);
+        }
+        else
+        {
+            mSkyline[i].x += overlap;
+            mSkyline[i].width -= overlap;
+            break;
+        }
+    }
+
+    // Neighbours at the same height merge back into one segment.
+    for (size_t j = 0; j + 1 < mSkyline.size();)
+    {
+        if (mSkyline[j].y == mSkyline[j + 1].y)
+        {
+            mSkyline[j].width += mSkyline[j + 1].width;
+            mSkyline.erase(mSkyline.begin() + j + 1);
+        }
+        else
+        {
+            ++j;
+        }
+    }
+    return true;
+}
+
+int SkylinePacker::getUsedHeight() const
+{
+    return mUsedHeight;
+}
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef SPATIALGRID_HPP
+#define SPATIALGRID_HPP
+
+#include <algorithm>
+#include <vector>
+#include <SDL2/SDL_rect.h>
+using namespace std;
+
+// Uniform grid over a fixed area. Each cell lists the ids of the rects that
+// touch it, so a point query only looks at one short bucket no matter how
+// many rects are stored. Rect edges are inclusive, matching the hand-written
+// "x >= r.x && x <= r.x + r.w" checks used across the screens.
+class SpatialGrid
+{
+public:
+    SpatialGrid(int width = 0, int height = 0, int cellSize = 64);
+    void reset(int width, int height, int cellSize);
+    void clear();
+    void insert(int id, const SDL_Rect &rect);
+    void remove(int id, const SDL_Rect &rect);
+    const vector<int> &candidatesAt(int x, int y) const;
+    void queryRect(const SDL_Rect &rect, vector<int> &ids) const;
+    int getWidth() const;
+    int getHeight() const;
+
+private:
+    int mWidth, mHeight, mCellSize;
+    int mColumns, mRows;
+    vector<vector<int>> mCells;
+    vector<int> mEmpty;
+
+    bool cellRange(const SDL_Rect &rect, int &firstColumn, int &firstRow, int &lastColumn, int &lastRow) const;
+};
+
+SpatialGrid::SpatialGrid(int width, int height, int cellSize)
+{
+    reset(width, height, cellSize);
+}
+
+void SpatialGrid::reset(int width, int height, int cellSize)
+{
+    mWidth = width;
+    mHeight = height;
+    mCellSize = cellSize > 0 ? cellSize : 64;
+    mColumns = width / mCellSize + 1;
+    mRows = height / mCellSize + 1;
+    mCells.assign(mColumns * mRows, vector<int>());
+}
+
+void SpatialGrid::clear()
+{
+    for (vector<int> &cell : mCells)
+    {
+        cell.clear();
+    }
+}
+
+bool SpatialGrid::cellRange(const SDL_Rect &rect, int &firstColumn, int &firstRow, int &lastColumn, int &lastRow) const
+{
+    int left = max(rect.x, 0);
+    int top = max(rect.y, 0);
+    int right = min(rect.x + rect.w, mWidth);
+    int bottom = min(rect.y + rect.h, mHeight);
+    if (left > right || top > bottom)
+    {
+        return false;
+    }
+    firstColumn = left / mCellSize;
+    firstRow = top / mCellSize;
+    lastColumn = right / mCellSize;
+    lastRow = bottom / mCellSize;
+    return true;
+}
+
+void SpatialGrid::insert(int id, const SDL_Rect &rect)
+{
+    int firstColumn, firstRow, lastColumn, lastRow;
+    if (!cellRange(rect, firstColumn, firstRow, lastColumn, lastRow))
+    {
+        return;
+    }
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = firstColumn; column <= lastColumn; ++column)
+        {
+            mCells[row * mColumns + column].push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::remove(int id, const SDL_Rect &rect)
+{
+    int firstColumn, firstRow, lastColumn, lastRow;
+    if (!cellRange(rect, firstColumn, firstRow, lastColumn, lastRow))
+    {
+        return;
+    }
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = firstColumn; column <= lastColumn; ++column)
+        {
+            vector<int> &cell = mCells[row * mColumns + column];
+            for (size_t i = 0; i < cell.size(); ++i)
+            {
+                if (cell[i] == id)
+                {
+                    cell.erase(cell.begin() + i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+const vector<int> &SpatialGrid::candidatesAt(int x, int y) const
+{
+    if (x < 0 || y < 0 || x > mWidth || y > mHeight)
+    {
+        return mEmpty;
+    }
+    return mCells[(y / mCellSize) * mColumns + x / mCellSize];
+}
+
+// Ids touching several cells are reported once per cell; callers that need
+// a set dedupe (the id order inside a cell is insertion order).
+void SpatialGrid::queryRect(const SDL_Rect &rect, vector<int> &ids) const
+{
+    ids.clear();
+    int firstColumn, firstRow, lastColumn, lastRow;
+    if (!cellRange(rect, firstColumn, firstRow, lastColumn, lastRow))
+    {
+        return;
+    }
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = firstColumn; column <= lastColumn; ++column)
+        {
+            const vector<int> &cell = mCells[row * mColumns + column];
+            ids.insert(ids.end(), cell.begin(), cell.end());
+        }
+    }
+}
+
+int SpatialGrid::getWidth() const
+{
+    return mWidth;
+}
+
+int SpatialGrid::getHeight() const
+{
+    return mHeight;
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef SPRITEBATCH_HPP
+#define SPRITEBATCH_HPP
+
+#include <iostream>
+#include <vector>
+#include <SDL2/SDL.h>
+using namespace std;
+
+// Collects quads and submits each run that shares a texture (or has none,
+// for solid fills) as one SDL_RenderGeometry call. Runs are cut only when
+// the texture changes, so drawing order is kept; sprites packed into one
+// atlas therefore go out together. Anything drawn straight to the renderer
+// in between (text, other copies) needs a flush() first.
+class SpriteBatch
+{
+public:
+    struct Stats
+    {
+        int drawCalls;
+        int quads;
+    };
+
+    SpriteBatch();
+    void begin(SDL_Renderer *renderer);
+    void fillRect(const SDL_Rect &rect, SDL_Color color);
+    void outlineRect(const SDL_Rect &rect, SDL_Color color);
+    void draw(SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect &dest, SDL_Color tint = {255, 255, 255, 255});
+    void flush();
+    Stats end();
+    void report(const char *scene);
+
+private:
+    SDL_Renderer *mRenderer;
+    SDL_Texture *mTexture;
+    int mTextureW, mTextureH;
+    vector<SDL_Vertex> mVertices;
+    vector<int> mIndices;
+    Stats mStats, mReported;
+    bool mFailed;
+
+    void addQuad(float x, float y, float w, float h, SDL_Color color, float u0, float v0, float u1, float v1);
+};
+
+SpriteBatch::SpriteBatch()
+{
+    mRenderer = NULL;
+    mTexture = NULL;
+    mTextureW = 1;
+    mTextureH = 1;
+    mStats = {0, 0};
+    mReported = {-1, -1};
+    mFailed = false;
+}
+
+void SpriteBatch::begin(SDL_Renderer *renderer)
+{
+    mRenderer = renderer;
+    mTexture = NULL;
+    mVertices.clear();
+    mIndices.clear();
+    mStats = {0, 0};
+}
+
+void SpriteBatch::addQuad(float x, float y, float w, float h, SDL_Color color, float u0, float v0, float u1, float v1)
+{
+    int first = (int)mVertices.size();
+    mVertices.push_back({{x, y}, color, {u0, v0}});
+    mVertices.push_back({{x + w, y}, color, {u1, v0}});
+    mVertices.push_back({{x + w, y + h}, color, {u1, v1}});
+    mVertices.push_back({{x, y + h}, color, {u0, v1}});
+    const int corners[6] = {0, 1, 2, 0, 2, 3};
+    for (int corner : corners)
+    {
+        mIndices.push_back(first + corner);
+    }
+    mStats.quads++;
+}
+
+void SpriteBatch::fillRect(const SDL_Rect &rect, SDL_Color color)
+{
+    if (mTexture != NULL)
+    {
+        flush();
+    }
+    addQuad((float)rect.x, (float)rect.y, (float)rect.w, (float)rect.h, color, 0, 0, 0, 0);
+}
+
+// Same pixels as SDL_RenderDrawRect: a one pixel frame inside the rect.
+void SpriteBatch::outlineRect(const SDL_Rect &rect, SDL_Color color)
+{
+    if (rect.w <= 0 || rect.h <= 0)
+    {
+        return;
+    }
+    fillRect({rect.x, rect.y, rect.w, 1}, color);
+    if (rect.h > 1)
+    {
+        fillRect({rect.x, rect.y + rect.h - 1, rect.w, 1}, color);
+    }
+    if (rect.h > 2)
+    {
+        fillRect({rect.x, rect.y + 1, 1, rect.h - 2}, color);
+        if (rect.w > 1)
+        {
+            fillRect({rect.x + rect.w - 1, rect.y + 1, 1, rect.h - 2}, color);
+        }
+    }
+}
+
+void SpriteBatch::draw(SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect &dest, SDL_Color tint)
+{
+    if (texture == NULL)
+    {
+        return;
+    }
+    if (texture != mTexture)
+    {
+        flush();
+        mTexture = texture;
+        if (SDL_QueryTexture(texture, NULL, NULL, &mTextureW, &mTextureH) != 0 || mTextureW <= 0 || mTextureH <= 0)
+        {
+            mTextureW = mTextureH = 1;
+        }
+    }
+    float u0 = 0, v0 = 0, u1 = 1, v1 = 1;
+    if (src != NULL)
+    {
+        u0 = (float)src->x / mTextureW;
+        v0 = (float)src->y / mTextureH;
+        u1 = (float)(src->x + src->w) / mTextureW;
+        v1 = (float)(src->y + src->h) / mTextureH;
+    }
+    addQuad((float)dest.x, (float)dest.y, (float)dest.w, (float)dest.h, tint, u0, v0, u1, v1);
+}
+
+void SpriteBatch::flush()
+{
+    if (!mIndices.empty() && mRenderer != NULL)
+    {
+        if (SDL_RenderGeometry(mRenderer, mTexture, mVertices.data(), (int)mVertices.size(), mIndices.data(), (int)mIndices.size()) != 0 &&
+            !mFailed)
+        {
+            cout << "SDL_RenderGeometry failed! SDL Error: " << SDL_GetError() << endl;
+            mFailed = true;
+        }
+        mStats.drawCalls++;
+    }
+    mVertices.clear();
+    mIndices.clear();
+    mTexture = NULL;
+}
+
+SpriteBatch::Stats SpriteBatch::end()
+{
+    flush();
+    return mStats;
+}
+
+// Prints the counts of the last frame whenever its number of draw calls
+// changes, so the saving per scene shows up in the console without one line
+// per frame. Only built with -DSPRITEBATCH_DEBUG; otherwise it does nothing.
+void SpriteBatch::report(const char *scene)
+{
+#ifdef SPRITEBATCH_DEBUG
+    if (mStats.drawCalls != mReported.drawCalls)
+    {
+        cout << scene << ": " << mStats.quads << " quads in " << mStats.drawCalls << " draw call"
+             << (mStats.drawCalls == 1 ? "" : "s") << endl;
+        mReported = mStats;
+    }
+#else
+    (void)scene;
+#endif
+}
+
+#endif
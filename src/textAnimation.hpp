@@ -0,0 +1,91 @@
+#ifndef TEXTANIMATION_HPP
+#define TEXTANIMATION_HPP
+
+#include <string>
+#include <SDL2/SDL.h>
+#include "glyphCache.hpp"
+using namespace std;
+
+// Typewriter reveal that is driven by the frame clock instead of sleeping.
+// Call update() once per frame; render() draws however many characters are
+// due by now, so the event loop keeps running while the text appears.
+class TextAnimation
+{
+public:
+    TextAnimation();
+    void start(const string &text, Uint32 msPerChar);
+    void update(Uint32 now);
+    void finish();
+    bool isDone() const;
+    bool isStarted() const;
+    size_t visibleCount() const;
+    int render(GlyphCache &glyphs, int x, int y, SDL_Color color);
+
+private:
+    string mText;
+    Uint32 mStartTime;
+    Uint32 mMsPerChar;
+    size_t mVisible;
+    bool mStarted;
+};
+
+TextAnimation::TextAnimation()
+{
+    mStartTime = 0;
+    mMsPerChar = 0;
+    mVisible = 0;
+    mStarted = false;
+}
+
+void TextAnimation::start(const string &text, Uint32 msPerChar)
+{
+    mText = text;
+    mMsPerChar = msPerChar;
+    mStartTime = SDL_GetTicks();
+    mVisible = 0;
+    mStarted = true;
+    update(mStartTime);
+}
+
+void TextAnimation::update(Uint32 now)
+{
+    if (!mStarted || isDone())
+    {
+        return;
+    }
+    if (mMsPerChar == 0)
+    {
+        mVisible = mText.length();
+        return;
+    }
+    // The first character shows immediately, one more every mMsPerChar.
+    size_t due = (now - mStartTime) / mMsPerChar + 1;
+    mVisible = min(due, mText.length());
+}
+
+void TextAnimation::finish()
+{
+    mVisible = mText.length();
+}
+
+bool TextAnimation::isDone() const
+{
+    return mVisible >= mText.length();
+}
+
+bool TextAnimation::isStarted() const
+{
+    return mStarted;
+}
+
+size_t TextAnimation::visibleCount() const
+{
+    return mVisible;
+}
+
+int TextAnimation::render(GlyphCache &glyphs, int x, int y, SDL_Color color)
+{
+    return glyphs.drawText(mText, mVisible, x, y, color);
+}
+
+#endif
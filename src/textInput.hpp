@@ -0,0 +1,430 @@
+#ifndef TEXTINPUT_HPP
+#define TEXTINPUT_HPP
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+#include "glyphCache.hpp"
+using namespace std;
+
+// One line of editable text, shared by every screen that asks the player to
+// type. Handles SDL_TEXTINPUT and SDL_TEXTEDITING (IME composition), caret
+// movement, shift-selection, backspace/delete and Ctrl+A/C/X/V.
+//
+// Nothing is rasterized per keystroke: the text is drawn as a run of glyphs
+// from a GlyphCache, and the pen position before every byte is kept, so an
+// edit only re-measures from the edit point onwards (one glyph when typing
+// or deleting at the end) and caret and selection positions are lookups.
+// Text is UTF-8; the caret and selection always sit on code point
+// boundaries.
+enum TextInputResult
+{
+    TEXT_IGNORED,
+    TEXT_HANDLED,
+    TEXT_EDITED,
+    TEXT_SUBMITTED
+};
+
+const Uint32 CARET_BLINK_MS = 500;
+
+class TextInput
+{
+public:
+    TextInput();
+    void init(SDL_Renderer *renderer, GlyphCache *glyphs, size_t maxLength = 256);
+    void start(const SDL_Rect &area);
+    void stop();
+    TextInputResult handleEvent(const SDL_Event &e);
+    bool update(Uint32 now);
+    void render(int x, int y, SDL_Color color);
+    const string &text() const;
+    void setText(const string &text);
+    void clear();
+    int width() const;
+
+private:
+    SDL_Renderer *mRenderer;
+    GlyphCache *mGlyphs;
+    string mText;
+    vector<int> mPositions;
+    size_t mCaret, mAnchor;
+    size_t mMaxLength;
+    string mComposition;
+    int mCompositionCursor;
+    Uint32 mBlinkStart;
+    bool mCaretVisible;
+    bool mDirty;
+
+    size_t previousBoundary(size_t i) const;
+    size_t nextBoundary(size_t i) const;
+    void remeasureFrom(size_t i);
+    bool hasSelection() const;
+    void deleteSelection();
+    void insert(const string &text);
+    void moveCaret(size_t to, bool extend);
+    void edited();
+};
+
+TextInput::TextInput()
+{
+    mRenderer = NULL;
+    mGlyphs = NULL;
+    mPositions.assign(1, 0);
+    mCaret = 0;
+    mAnchor = 0;
+    mMaxLength = 256;
+    mCompositionCursor = 0;
+    mBlinkStart = 0;
+    mCaretVisible = true;
+    mDirty = true;
+}
+
+void TextInput::init(SDL_Renderer *renderer, GlyphCache *glyphs, size_t maxLength)
+{
+    mRenderer = renderer;
+    mGlyphs = glyphs;
+    mMaxLength = maxLength;
+    clear();
+}
+
+// The area is where the IME shows its candidate window.
+void TextInput::start(const SDL_Rect &area)
+{
+    SDL_Rect rect = area;
+    SDL_SetTextInputRect(&rect);
+    SDL_StartTextInput();
+    mBlinkStart = SDL_GetTicks();
+    mDirty = true;
+}
+
+void TextInput::stop()
+{
+    SDL_StopTextInput();
+    mComposition.clear();
+}
+
+size_t TextInput::previousBoundary(size_t i) const
+{
+    if (i == 0)
+    {
+        return 0;
+    }
+    --i;
+    while (i > 0 && ((unsigned char)mText[i] & 0xC0) == 0x80)
+    {
+        --i;
+    }
+    return i;
+}
+
+size_t TextInput::nextBoundary(size_t i) const
+{
+    if (i >= mText.length())
+    {
+        return mText.length();
+    }
+    ++i;
+    while (i < mText.length() && ((unsigned char)mText[i] & 0xC0) == 0x80)
+    {
+        ++i;
+    }
+    return i;
+}
+
+// mPositions[k] is where the pen stands before byte k, exactly as
+// GlyphCache::drawRun advances it, so only the tail after an edit changes.
+void TextInput::remeasureFrom(size_t i)
+{
+    mPositions.resize(mText.length() + 1);
+    for (size_t k = i; k < mText.length(); ++k)
+    {
+        int pen = mPositions[k];
+        if (mGlyphs != NULL)
+        {
+            if (k > 0)
+            {
+                pen += mGlyphs->kerning(mText[k - 1], mText[k]);
+            }
+            pen += mGlyphs->advance(mText[k]);
+        }
+        mPositions[k + 1] = pen;
+    }
+}
+
+bool TextInput::hasSelection() const
+{
+    return mCaret != mAnchor;
+}
+
+void TextInput::deleteSelection()
+{
+    size_t from = min(mCaret, mAnchor);
+    size_t to = max(mCaret, mAnchor);
+    mText.erase(from, to - from);
+    mCaret = from;
+    mAnchor = from;
+    // Kerning ties a glyph to the one before it, so the edit point's
+    // neighbour is measured again too.
+    remeasureFrom(from > 0 ? from - 1 : 0);
+}
+
+// Replaces the selection. Line breaks are dropped and the text is cut at
+// mMaxLength, on a code point boundary.
+void TextInput::insert(const string &text)
+{
+    deleteSelection();
+    string clean;
+    for (char c : text)
+    {
+        if (c != '\n' && c != '\r')
+        {
+            clean += c;
+        }
+    }
+    size_t room = mMaxLength > mText.length() ? mMaxLength - mText.length() : 0;
+    if (clean.length() > room)
+    {
+        // Step back to a lead byte so a code point is never split.
+        while (room > 0 && ((unsigned char)clean[room] & 0xC0) == 0x80)
+        {
+            --room;
+        }
+        clean.erase(room);
+    }
+    mText.insert(mCaret, clean);
+    size_t from = mCaret;
+    mCaret += clean.length();
+    mAnchor = mCaret;
+    remeasureFrom(from > 0 ? from - 1 : 0);
+}
+
+void TextInput::moveCaret(size_t to, bool extend)
+{
+    mCaret = to;
+    if (!extend)
+    {
+        mAnchor = to;
+    }
+    edited();
+}
+
+// Any change shows the caret at once and restarts its blink.
+void TextInput::edited()
+{
+    mBlinkStart = SDL_GetTicks();
+    mCaretVisible = true;
+    mDirty = true;
+}
+
+TextInputResult TextInput::handleEvent(const SDL_Event &e)
+{
+    if (e.type == SDL_TEXTINPUT)
+    {
+        // Ctrl+C and Ctrl+V arrive as text on some platforms as well.
+        if (SDL_GetModState() & KMOD_CTRL && (e.text.text[0] == 'c' || e.text.text[0] == 'C' || e.text.text[0] == 'v' || e.text.text[0] == 'V'))
+        {
+            return TEXT_IGNORED;
+        }
+        mComposition.clear();
+        insert(e.text.text);
+        edited();
+        return TEXT_EDITED;
+    }
+    if (e.type == SDL_TEXTEDITING)
+    {
+        mComposition = e.edit.text;
+        mCompositionCursor = e.edit.start;
+        edited();
+        return TEXT_HANDLED;
+    }
+    if (e.type != SDL_KEYDOWN || !mComposition.empty())
+    {
+        // While composing, keys belong to the IME.
+        return TEXT_IGNORED;
+    }
+
+    SDL_Keycode key = e.key.keysym.sym;
+    bool ctrl = (e.key.keysym.mod & KMOD_CTRL) != 0;
+    bool shift = (e.key.keysym.mod & KMOD_SHIFT) != 0;
+    switch (key)
+    {
+    case SDLK_RETURN:
+    case SDLK_KP_ENTER:
+        return TEXT_SUBMITTED;
+    case SDLK_BACKSPACE:
+        if (!hasSelection())
+        {
+            mAnchor = previousBoundary(mCaret);
+        }
+        if (!hasSelection())
+        {
+            return TEXT_HANDLED;
+        }
+        deleteSelection();
+        edited();
+        return TEXT_EDITED;
+    case SDLK_DELETE:
+        if (!hasSelection())
+        {
+            mAnchor = nextBoundary(mCaret);
+        }
+        if (!hasSelection())
+        {
+            return TEXT_HANDLED;
+        }
+        deleteSelection();
+        edited();
+        return TEXT_EDITED;
+    case SDLK_LEFT:
+        moveCaret(hasSelection() && !shift ? min(mCaret, mAnchor) : previousBoundary(mCaret), shift);
+        return TEXT_HANDLED;
+    case SDLK_RIGHT:
+        moveCaret(hasSelection() && !shift ? max(mCaret, mAnchor) : nextBoundary(mCaret), shift);
+        return TEXT_HANDLED;
+    case SDLK_HOME:
+        moveCaret(0, shift);
+        return TEXT_HANDLED;
+    case SDLK_END:
+        moveCaret(mText.length(), shift);
+        return TEXT_HANDLED;
+    default:
+        break;
+    }
+    if (!ctrl)
+    {
+        return TEXT_IGNORED;
+    }
+    if (key == SDLK_a)
+    {
+        mAnchor = 0;
+        moveCaret(mText.length(), true);
+        return TEXT_HANDLED;
+    }
+    // Copy and cut take the selection, or the whole line when nothing is
+    // selected.
+    if (key == SDLK_c || key == SDLK_x)
+    {
+        if (!hasSelection())
+        {
+            mAnchor = 0;
+            mCaret = mText.length();
+        }
+        size_t from = min(mCaret, mAnchor);
+        SDL_SetClipboardText(mText.substr(from, max(mCaret, mAnchor) - from).c_str());
+        if (key == SDLK_x)
+        {
+            deleteSelection();
+            edited();
+            return TEXT_EDITED;
+        }
+        moveCaret(mCaret, true);
+        return TEXT_HANDLED;
+    }
+    if (key == SDLK_v && SDL_HasClipboardText())
+    {
+        char *clipboard = SDL_GetClipboardText();
+        insert(clipboard);
+        SDL_free(clipboard);
+        edited();
+        return TEXT_EDITED;
+    }
+    return TEXT_IGNORED;
+}
+
+// True when the field looks different than at the last render: an edit, or
+// the caret blinking on or off.
+bool TextInput::update(Uint32 now)
+{
+    bool visible = ((now - mBlinkStart) / CARET_BLINK_MS) % 2 == 0;
+    if (visible != mCaretVisible)
+    {
+        mCaretVisible = visible;
+        mDirty = true;
+    }
+    return mDirty;
+}
+
+void TextInput::render(int x, int y, SDL_Color color)
+{
+    mDirty = false;
+    if (mGlyphs == NULL)
+    {
+        return;
+    }
+    int height = mGlyphs->lineHeight();
+    if (hasSelection())
+    {
+        int from = mPositions[min(mCaret, mAnchor)];
+        int to = mPositions[max(mCaret, mAnchor)];
+        SDL_Rect highlight = {x + from, y, to - from, height};
+        SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(mRenderer, color.r, color.g, color.b, 80);
+        SDL_RenderFillRect(mRenderer, &highlight);
+    }
+
+    // The composition is drawn at the caret, underlined, without being part
+    // of the text until the IME commits it. Without one the text is a single
+    // run, so the pair around the caret keeps its kerning.
+    int caretX = x + mPositions[mCaret];
+    int composed = 0;
+    if (mComposition.empty())
+    {
+        mGlyphs->drawRun(mText, 0, mText.length(), x, y, color);
+    }
+    else
+    {
+        mGlyphs->drawRun(mText, 0, mCaret, x, y, color);
+        composed = mGlyphs->drawRun(mComposition, 0, mComposition.length(), caretX, y, color);
+        mGlyphs->drawRun(mText, mCaret, mText.length() - mCaret, caretX + composed, y, color);
+    }
+
+    SDL_SetRenderDrawColor(mRenderer, color.r, color.g, color.b, color.a);
+    if (!mComposition.empty())
+    {
+        SDL_RenderDrawLine(mRenderer, caretX, y + height - 2, caretX + composed, y + height - 2);
+        // The IME counts its cursor in code points.
+        size_t cursor = 0;
+        for (int c = 0; c < mCompositionCursor && cursor < mComposition.length(); ++c)
+        {
+            ++cursor;
+            while (cursor < mComposition.length() && ((unsigned char)mComposition[cursor] & 0xC0) == 0x80)
+            {
+                ++cursor;
+            }
+        }
+        caretX += mGlyphs->measureRun(mComposition, 0, cursor);
+    }
+    if (mCaretVisible)
+    {
+        SDL_Rect caret = {caretX, y, 2, height};
+        SDL_RenderFillRect(mRenderer, &caret);
+    }
+}
+
+const string &TextInput::text() const
+{
+    return mText;
+}
+
+void TextInput::setText(const string &text)
+{
+    mText.clear();
+    mCaret = 0;
+    mAnchor = 0;
+    mPositions.assign(1, 0);
+    insert(text);
+    edited();
+}
+
+void TextInput::clear()
+{
+    setText("");
+}
+
+int TextInput::width() const
+{
+    return mPositions.back();
+}
+
+#endif
@@ -0,0 +1,218 @@
+#ifndef TEXTLAYOUT_HPP
+#define TEXTLAYOUT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <SDL2/SDL.h>
+#include "glyphCache.hpp"
+using namespace std;
+
+// Breaks text into lines that fit a pixel width, using the advances and
+// kerning a GlyphCache has already measured for its font. The result is a
+// list of glyph runs, each a slice of the source text with its pen position,
+// so drawing a laid-out block is one pass of GlyphCache::drawRun calls and
+// nothing is measured again until the text or width changes.
+enum LineBreaking
+{
+    BREAK_GREEDY,
+    BREAK_BALANCED
+};
+
+enum TextAlign
+{
+    ALIGN_LEFT,
+    ALIGN_CENTER
+};
+
+struct GlyphRun
+{
+    size_t start, length;
+    int x, y, width;
+};
+
+struct TextLayout
+{
+    vector<GlyphRun> runs;
+    int width, height;
+};
+
+// Both breakers take the width of every word and of the whitespace after it,
+// and fill lineStarts with the index of the first word on each line. A word
+// wider than maxWidth gets a line of its own.
+int spanWidth(const vector<int> &positions, const vector<int> &widths, int first, int last)
+{
+    return positions[last] + widths[last] - positions[first];
+}
+
+void wordPositions(const vector<int> &widths, const vector<int> &gaps, vector<int> &positions)
+{
+    positions.resize(widths.size());
+    int x = 0;
+    for (size_t i = 0; i < widths.size(); ++i)
+    {
+        positions[i] = x;
+        x += widths[i] + gaps[i];
+    }
+}
+
+// First fit: each line takes as many words as fit.
+void breakGreedy(const vector<int> &widths, const vector<int> &gaps, int maxWidth, vector<int> &lineStarts)
+{
+    vector<int> positions;
+    wordPositions(widths, gaps, positions);
+    lineStarts.clear();
+    int n = (int)widths.size();
+    int first = 0;
+    while (first < n)
+    {
+        lineStarts.push_back(first);
+        int last = first;
+        while (last + 1 < n && spanWidth(positions, widths, first, last + 1) <= maxWidth)
+        {
+            ++last;
+        }
+        first = last + 1;
+    }
+}
+
+// Knuth-Plass without stretch or hyphenation: picks the breaks that minimise
+// the sum of squared slack over all lines but the last, by dynamic programming
+// from the end of the paragraph. Lines come out evenly filled instead of one
+// long line followed by a short one.
+void breakBalanced(const vector<int> &widths, const vector<int> &gaps, int maxWidth, vector<int> &lineStarts)
+{
+    vector<int> positions;
+    wordPositions(widths, gaps, positions);
+    int n = (int)widths.size();
+    vector<int64_t> best(n + 1, 0);
+    vector<int> next(n + 1, n);
+    for (int first = n - 1; first >= 0; --first)
+    {
+        best[first] = INT64_MAX;
+        for (int last = first; last < n; ++last)
+        {
+            int width = spanWidth(positions, widths, first, last);
+            if (width > maxWidth && last > first)
+            {
+                break;
+            }
+            int64_t slack = max(0, maxWidth - width);
+            int64_t cost = (last == n - 1 ? 0 : slack * slack) + best[last + 1];
+            if (cost < best[first])
+            {
+                best[first] = cost;
+                next[first] = last + 1;
+            }
+        }
+    }
+    lineStarts.clear();
+    for (int first = 0; first < n; first = next[first])
+    {
+        lineStarts.push_back(first);
+    }
+}
+
+// Lays text[start, start + length) out in a box maxWidth wide with its
+// top-left corner at (0, 0). Spaces collapse only at line breaks; '\n' starts
+// a new paragraph. The runs point into text, which must outlive the layout.
+void layoutText(GlyphCache &glyphs, string_view text, size_t start, size_t length, int maxWidth, TextLayout &layout,
+                LineBreaking breaking = BREAK_BALANCED, TextAlign align = ALIGN_LEFT)
+{
+    layout.runs.clear();
+    layout.width = 0;
+    layout.height = 0;
+    int lineHeight = glyphs.lineHeight();
+
+    vector<size_t> starts, ends;
+    vector<int> widths, gaps, positions, lineStarts;
+    size_t end = min(text.length(), start + length);
+    size_t paragraphStart = min(start, end);
+    while (paragraphStart <= end)
+    {
+        size_t paragraphEnd = text.find('\n', paragraphStart);
+        if (paragraphEnd == string_view::npos || paragraphEnd > end)
+        {
+            paragraphEnd = end;
+        }
+
+        starts.clear();
+        ends.clear();
+        size_t i = paragraphStart;
+        while (i < paragraphEnd)
+        {
+            while (i < paragraphEnd && text[i] == ' ')
+            {
+                ++i;
+            }
+            if (i == paragraphEnd)
+            {
+                break;
+            }
+            starts.push_back(i);
+            while (i < paragraphEnd && text[i] != ' ')
+            {
+                ++i;
+            }
+            ends.push_back(i);
+        }
+
+        size_t n = starts.size();
+        widths.resize(n);
+        gaps.resize(n);
+        for (size_t w = 0; w < n; ++w)
+        {
+            widths[w] = glyphs.measureRun(text, starts[w], ends[w] - starts[w]);
+            gaps[w] = w + 1 < n ? glyphs.measureRun(text, ends[w], starts[w + 1] - ends[w]) : 0;
+        }
+        if (breaking == BREAK_GREEDY)
+        {
+            breakGreedy(widths, gaps, maxWidth, lineStarts);
+        }
+        else
+        {
+            breakBalanced(widths, gaps, maxWidth, lineStarts);
+        }
+        wordPositions(widths, gaps, positions);
+
+        for (size_t line = 0; line < lineStarts.size(); ++line)
+        {
+            int first = lineStarts[line];
+            int last = line + 1 < lineStarts.size() ? lineStarts[line + 1] - 1 : (int)n - 1;
+            GlyphRun run;
+            run.start = starts[first];
+            run.length = ends[last] - starts[first];
+            run.width = spanWidth(positions, widths, first, last);
+            run.x = align == ALIGN_CENTER ? (maxWidth - run.width) / 2 : 0;
+            run.y = layout.height;
+            layout.runs.push_back(run);
+            layout.width = max(layout.width, run.width);
+            layout.height += lineHeight;
+        }
+        if (n == 0)
+        {
+            layout.height += lineHeight;
+        }
+        paragraphStart = paragraphEnd + 1;
+    }
+}
+
+void layoutText(GlyphCache &glyphs, string_view text, int maxWidth, TextLayout &layout,
+                LineBreaking breaking = BREAK_BALANCED, TextAlign align = ALIGN_LEFT)
+{
+    layoutText(glyphs, text, 0, text.length(), maxWidth, layout, breaking, align);
+}
+
+void drawLayout(GlyphCache &glyphs, string_view text, const TextLayout &layout, int x, int y, SDL_Color color)
+{
+    glyphs.beginBatch();
+    for (const GlyphRun &run : layout.runs)
+    {
+        glyphs.drawRun(text, run.start, run.length, x + run.x, y + run.y, color);
+    }
+    glyphs.endBatch();
+}
+
+#endif
@@ -0,0 +1,410 @@
+#ifndef TEXTUREATLAS_HPP
+#define TEXTUREATLAS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include "hitMask.hpp"
+#include "skylinePacker.hpp"
+#include "spriteBatch.hpp"
+using namespace std;
+
+// Small sprites are packed into one page so they share a texture and go out
+// in one batched draw. tools/atlasPacker writes the page and its manifest
+// ahead of time (`make atlas`); when they are missing the same packing runs
+// at load from the source list, so the game never depends on the tool.
+//
+// Manifest format, one entry per line:
+//   page <image> <width> <height>
+//   <name> <x> <y> <w> <h>
+// Names are the source file names without directory or extension.
+const int ATLAS_MAX_SPRITE = 128;
+const int ATLAS_PADDING = 1;
+const int ATLAS_MAX_PAGE = 4096;
+
+string atlasSpriteName(const string &path)
+{
+    size_t slash = path.find_last_of("/\\");
+    size_t start = slash == string::npos ? 0 : slash + 1;
+    size_t dot = path.find_last_of('.');
+    if (dot == string::npos || dot < start)
+    {
+        dot = path.size();
+    }
+    return path.substr(start, dot - start);
+}
+
+bool readAtlasSources(const string &listPath, vector<string> &paths)
+{
+    ifstream file(listPath);
+    if (!file)
+    {
+        cout << "Unable to open atlas source list " << listPath << endl;
+        return false;
+    }
+    string line;
+    while (getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (!line.empty() && line[0] != '#')
+        {
+            paths.push_back(line);
+        }
+    }
+    return true;
+}
+
+// Box-filters an RGBA32 image down so neither side exceeds maxSide. Colour is
+// averaged weighted by alpha so transparent texels do not darken the edges.
+SDL_Surface *shrinkToFit(SDL_Surface *rgba, int maxSide)
+{
+    int width = rgba->w, height = rgba->h;
+    if (width > maxSide || height > maxSide)
+    {
+        if (width >= height)
+        {
+            height = max(1, height * maxSide / width);
+            width = maxSide;
+        }
+        else
+        {
+            width = max(1, width * maxSide / height);
+            height = maxSide;
+        }
+    }
+    SDL_Surface *result = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (result == NULL)
+    {
+        return NULL;
+    }
+
+    const unsigned char *src = (const unsigned char *)rgba->pixels;
+    unsigned char *dst = (unsigned char *)result->pixels;
+    for (int y = 0; y < height; ++y)
+    {
+        int y0 = y * rgba->h / height;
+        int y1 = max(y0 + 1, (y + 1) * rgba->h / height);
+        for (int x = 0; x < width; ++x)
+        {
+            int x0 = x * rgba->w / width;
+            int x1 = max(x0 + 1, (x + 1) * rgba->w / width);
+            uint64_t r = 0, g = 0, b = 0, a = 0;
+            for (int sy = y0; sy < y1; ++sy)
+            {
+                const unsigned char *p = src + (size_t)sy * rgba->pitch + 4 * x0;
+                for (int sx = x0; sx < x1; ++sx, p += 4)
+                {
+                    r += p[0] * p[3];
+                    g += p[1] * p[3];
+                    b += p[2] * p[3];
+                    a += p[3];
+                }
+            }
+            uint64_t count = (uint64_t)(y1 - y0) * (x1 - x0);
+            unsigned char *out = dst + (size_t)y * result->pitch + 4 * x;
+            out[0] = a ? (unsigned char)(r / a) : 0;
+            out[1] = a ? (unsigned char)(g / a) : 0;
+            out[2] = a ? (unsigned char)(b / a) : 0;
+            out[3] = (unsigned char)((a + count / 2) / count);
+        }
+    }
+    return result;
+}
+
+// Loads and shrinks every source, then packs them tallest first into the
+// smallest square page (trimmed to the used height) that holds them all.
+// Returns an RGBA32 page, or NULL if a source fails to load.
+SDL_Surface *packAtlas(const vector<string> &paths, int maxSide, int padding, vector<string> &names, vector<SDL_Rect> &rects)
+{
+    names.clear();
+    rects.clear();
+    vector<SDL_Surface *> sprites;
+    for (const string &path : paths)
+    {
+        SDL_Surface *loaded = IMG_Load(path.c_str());
+        SDL_Surface *rgba = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0) : NULL;
+        SDL_FreeSurface(loaded);
+        SDL_Surface *shrunk = rgba ? shrinkToFit(rgba, maxSide) : NULL;
+        SDL_FreeSurface(rgba);
+        if (shrunk == NULL)
+        {
+            cout << "Unable to add " << path << " to atlas! SDL_image Error: " << IMG_GetError() << endl;
+            for (SDL_Surface *sprite : sprites)
+            {
+                SDL_FreeSurface(sprite);
+            }
+            return NULL;
+        }
+        sprites.push_back(shrunk);
+        names.push_back(atlasSpriteName(path));
+    }
+
+    vector<int> order(sprites.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = (int)i;
+    }
+    sort(order.begin(), order.end(), [&](int a, int b) { return sprites[a]->h > sprites[b]->h; });
+
+    rects.assign(sprites.size(), SDL_Rect{0, 0, 0, 0});
+    SkylinePacker packer;
+    int side = 64;
+    bool packed = false;
+    while (!packed && side <= ATLAS_MAX_PAGE)
+    {
+        packer.reset(side, side, padding);
+        packed = true;
+        for (int i : order)
+        {
+            if (!packer.insert(sprites[i]->w, sprites[i]->h, rects[i]))
+            {
+                packed = false;
+                side *= 2;
+                break;
+            }
+        }
+    }
+
+    SDL_Surface *page = NULL;
+    if (packed)
+    {
+        page = SDL_CreateRGBSurfaceWithFormat(0, side, max(1, packer.getUsedHeight()), 32, SDL_PIXELFORMAT_RGBA32);
+    }
+    if (page == NULL)
+    {
+        cout << "Unable to pack atlas of " << sprites.size() << " sprites!" << endl;
+    }
+    for (size_t i = 0; i < sprites.size(); ++i)
+    {
+        if (page != NULL)
+        {
+            SDL_SetSurfaceBlendMode(sprites[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(sprites[i], NULL, page, &rects[i]);
+        }
+        SDL_FreeSurface(sprites[i]);
+    }
+    return page;
+}
+
+// One packed page plus the sub-rect of every sprite in it. Sits beside
+// LTexture: render() copies one sprite the way LTexture::render does, and
+// draw() queues it into a SpriteBatch. The page pixels are kept after load so
+// hit masks can be cut from the sub-rects; releasePixels() drops them.
+class TextureAtlas
+{
+public:
+    TextureAtlas();
+    ~TextureAtlas();
+    bool load(SDL_Renderer *renderer, const string &manifestPath, const string &sourceList);
+    void free();
+    void releasePixels();
+    int find(const string &name) const;
+    int size() const;
+    SDL_Texture *getTexture() const;
+    const SDL_Rect &getRect(int sprite) const;
+    int getWidth(int sprite) const;
+    int getHeight(int sprite) const;
+    void render(SDL_Renderer *renderer, int sprite, const SDL_Rect &dest) const;
+    void draw(SpriteBatch &batch, int sprite, const SDL_Rect &dest, SDL_Color tint = {255, 255, 255, 255}) const;
+    bool buildHitMask(int sprite, HitMask &mask) const;
+
+private:
+    SDL_Texture *mTexture;
+    SDL_Surface *mPixels;
+    vector<string> mNames;
+    vector<SDL_Rect> mRects;
+
+    bool loadManifest(const string &manifestPath);
+};
+
+TextureAtlas::TextureAtlas()
+{
+    mTexture = NULL;
+    mPixels = NULL;
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    free();
+}
+
+// A missing manifest is the normal case until `make atlas` has been run, so
+// only a manifest that exists but cannot be used is reported.
+bool TextureAtlas::loadManifest(const string &manifestPath)
+{
+    ifstream file(manifestPath);
+    if (!file)
+    {
+        return false;
+    }
+    string line, pagePath;
+    int pageWidth = 0, pageHeight = 0;
+    int lineNumber = 0;
+    while (getline(file, line))
+    {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        istringstream fields(line);
+        string name;
+        fields >> name;
+        if (name == "page")
+        {
+            fields >> pagePath >> pageWidth >> pageHeight;
+            continue;
+        }
+        SDL_Rect rect;
+        if (!(fields >> rect.x >> rect.y >> rect.w >> rect.h) || rect.x < 0 || rect.y < 0 ||
+            rect.x + rect.w > pageWidth || rect.y + rect.h > pageHeight)
+        {
+            cout << manifestPath << ":" << lineNumber << ": bad atlas entry" << endl;
+            return false;
+        }
+        mNames.push_back(name);
+        mRects.push_back(rect);
+    }
+
+    SDL_Surface *page = pagePath.empty() ? NULL : IMG_Load(pagePath.c_str());
+    if (page == NULL || page->w != pageWidth || page->h != pageHeight)
+    {
+        cout << "Atlas page " << pagePath << " does not match " << manifestPath << endl;
+        SDL_FreeSurface(page);
+        return false;
+    }
+    mPixels = SDL_ConvertSurfaceFormat(page, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(page);
+    return mPixels != NULL;
+}
+
+bool TextureAtlas::load(SDL_Renderer *renderer, const string &manifestPath, const string &sourceList)
+{
+    free();
+    if (!loadManifest(manifestPath))
+    {
+        mNames.clear();
+        mRects.clear();
+        vector<string> paths;
+        if (!readAtlasSources(sourceList, paths))
+        {
+            return false;
+        }
+        mPixels = packAtlas(paths, ATLAS_MAX_SPRITE, ATLAS_PADDING, mNames, mRects);
+        if (mPixels == NULL)
+        {
+            mNames.clear();
+            mRects.clear();
+            return false;
+        }
+    }
+
+    mTexture = SDL_CreateTextureFromSurface(renderer, mPixels);
+    if (mTexture == NULL)
+    {
+        cout << "Unable to create atlas texture! SDL Error: " << SDL_GetError() << endl;
+        free();
+        return false;
+    }
+    SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+// Safe to call twice; the texture pointer is cleared so a second call after
+// the renderer is gone does nothing.
+void TextureAtlas::free()
+{
+    if (mTexture != NULL)
+    {
+        SDL_DestroyTexture(mTexture);
+        mTexture = NULL;
+    }
+    releasePixels();
+    mNames.clear();
+    mRects.clear();
+}
+
+void TextureAtlas::releasePixels()
+{
+    if (mPixels != NULL)
+    {
+        SDL_FreeSurface(mPixels);
+        mPixels = NULL;
+    }
+}
+
+int TextureAtlas::find(const string &name) const
+{
+    for (size_t i = 0; i < mNames.size(); ++i)
+    {
+        if (mNames[i] == name)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+int TextureAtlas::size() const
+{
+    return (int)mNames.size();
+}
+
+SDL_Texture *TextureAtlas::getTexture() const
+{
+    return mTexture;
+}
+
+const SDL_Rect &TextureAtlas::getRect(int sprite) const
+{
+    return mRects[sprite];
+}
+
+int TextureAtlas::getWidth(int sprite) const
+{
+    return mRects[sprite].w;
+}
+
+int TextureAtlas::getHeight(int sprite) const
+{
+    return mRects[sprite].h;
+}
+
+void TextureAtlas::render(SDL_Renderer *renderer, int sprite, const SDL_Rect &dest) const
+{
+    if (mTexture != NULL && sprite >= 0 && sprite < size())
+    {
+        SDL_RenderCopy(renderer, mTexture, &mRects[sprite], &dest);
+    }
+}
+
+void TextureAtlas::draw(SpriteBatch &batch, int sprite, const SDL_Rect &dest, SDL_Color tint) const
+{
+    if (sprite >= 0 && sprite < size())
+    {
+        batch.draw(mTexture, &mRects[sprite], dest, tint);
+    }
+}
+
+bool TextureAtlas::buildHitMask(int sprite, HitMask &mask) const
+{
+    if (mPixels == NULL || sprite < 0 || sprite >= size())
+    {
+        return false;
+    }
+    const SDL_Rect &rect = mRects[sprite];
+    const unsigned char *origin = (const unsigned char *)mPixels->pixels + (size_t)rect.y * mPixels->pitch + 4 * rect.x;
+    mask.buildFromRGBA(origin, rect.w, rect.h, mPixels->pitch);
+    return true;
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef WIDGETS_HPP
+#define WIDGETS_HPP
+
+#include <vector>
+#include <SDL2/SDL.h>
+#include "spatialGrid.hpp"
+using namespace std;
+
+// Clickable rects of one screen, indexed by a SpatialGrid so a pointer event
+// reaches its widget after looking at a single grid cell. The registry also
+// remembers which widget is hovered and which one is held down.
+class WidgetRegistry
+{
+public:
+    WidgetRegistry(int width, int height, int cellSize = 64);
+    void add(int id, const SDL_Rect &rect);
+    void clear();
+    int hitTest(int x, int y) const;
+    int handleEvent(const SDL_Event &e);
+    int hovered() const;
+    int pressed() const;
+
+private:
+    struct Widget
+    {
+        int id;
+        SDL_Rect rect;
+    };
+
+    vector<Widget> mWidgets;
+    SpatialGrid mGrid;
+    int mHovered;
+    int mPressed;
+};
+
+WidgetRegistry::WidgetRegistry(int width, int height, int cellSize)
+    : mGrid(width, height, cellSize), mHovered(-1), mPressed(-1)
+{
+}
+
+void WidgetRegistry::add(int id, const SDL_Rect &rect)
+{
+    mGrid.insert((int)mWidgets.size(), rect);
+    mWidgets.push_back({id, rect});
+}
+
+void WidgetRegistry::clear()
+{
+    mWidgets.clear();
+    mGrid.clear();
+    mHovered = -1;
+    mPressed = -1;
+}
+
+// Returns the id of the widget under the point, or -1. When widgets overlap
+// the one added last wins, as it would be drawn on top.
+int WidgetRegistry::hitTest(int x, int y) const
+{
+    const vector<int> &candidates = mGrid.candidatesAt(x, y);
+    for (int i = (int)candidates.size() - 1; i >= 0; --i)
+    {
+        const SDL_Rect &rect = mWidgets[candidates[i]].rect;
+        if (x >= rect.x && x <= rect.x + rect.w && y >= rect.y && y <= rect.y + rect.h)
+        {
+            return mWidgets[candidates[i]].id;
+        }
+    }
+    return -1;
+}
+
+// Updates hover/press state. Returns the id of the widget clicked by a left
+// button press, or -1 for any other event.
+int WidgetRegistry::handleEvent(const SDL_Event &e)
+{
+    if (e.type == SDL_MOUSEMOTION)
+    {
+        mHovered = hitTest(e.motion.x, e.motion.y);
+    }
+    else if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT)
+    {
+        mPressed = hitTest(e.button.x, e.button.y);
+        return mPressed;
+    }
+    else if (e.type == SDL_MOUSEBUTTONUP && e.button.button == SDL_BUTTON_LEFT)
+    {
+        mPressed = -1;
+    }
+    return -1;
+}
+
+int WidgetRegistry::hovered() const
+{
+    return mHovered;
+}
+
+int WidgetRegistry::pressed() const
+{
+    return mPressed;
+}
+
+#endif
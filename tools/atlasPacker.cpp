@@ -0,0 +1,74 @@
+// Packs the sprites listed in a source list into one atlas page and writes
+// the page as PNG plus the manifest TextureAtlas reads at startup.
+// Usage: atlasPacker <sources.txt> <page.png> <manifest.txt>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include "../src/textureAtlas.hpp"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    if (argc != 4)
+    {
+        cout << "Usage: atlasPacker <sources.txt> <page.png> <manifest.txt>" << endl;
+        return 1;
+    }
+    if (IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) == 0)
+    {
+        cout << "SDL_image could not initialize! SDL_image Error: " << IMG_GetError() << endl;
+        return 1;
+    }
+
+    vector<string> paths;
+    if (!readAtlasSources(argv[1], paths))
+    {
+        IMG_Quit();
+        return 1;
+    }
+    auto start = chrono::steady_clock::now();
+    vector<string> names;
+    vector<SDL_Rect> rects;
+    SDL_Surface *page = packAtlas(paths, ATLAS_MAX_SPRITE, ATLAS_PADDING, names, rects);
+    double packMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    if (page == NULL)
+    {
+        IMG_Quit();
+        return 1;
+    }
+
+    bool ok = IMG_SavePNG(page, argv[2]) == 0;
+    if (!ok)
+    {
+        cout << "Unable to write " << argv[2] << "! SDL_image Error: " << IMG_GetError() << endl;
+    }
+    ofstream manifest(argv[3]);
+    manifest << "# Generated by tools/atlasPacker from " << argv[1] << "\n";
+    manifest << "page " << argv[2] << " " << page->w << " " << page->h << "\n";
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        manifest << names[i] << " " << rects[i].x << " " << rects[i].y << " " << rects[i].w << " " << rects[i].h << "\n";
+    }
+    manifest.close();
+    if (!manifest)
+    {
+        cout << "Unable to write " << argv[3] << endl;
+        ok = false;
+    }
+
+    int used = 0;
+    for (const SDL_Rect &rect : rects)
+    {
+        used += rect.w * rect.h;
+    }
+    cout << names.size() << " sprites into " << page->w << "x" << page->h << " ("
+         << 100 * used / (page->w * page->h) << "% used) in " << packMs << " ms" << endl;
+    SDL_FreeSurface(page);
+    IMG_Quit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+// Measures batch encode/decode throughput of every cipher in cipher.hpp and
+// checks the vectorized kernels against the scalar ones.
+// Usage: cipherBench [megabytes]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/cipher.hpp"
+
+using namespace std;
+
+double megabytesPerSecond(size_t bytes, chrono::steady_clock::duration elapsed)
+{
+    double seconds = chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0;
+}
+
+template <typename Work>
+double timeRuns(size_t bytes, int runs, Work work)
+{
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < runs; ++r)
+    {
+        work();
+    }
+    return megabytesPerSecond(bytes * runs, chrono::steady_clock::now() - start);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 64;
+    size_t n = megabytes * 1024 * 1024;
+    const int runs = 5;
+
+    // Word-list shaped input: mixed-case words, spaces and the odd digit.
+    string text(n, ' ');
+    mt19937 gen(42);
+    uniform_int_distribution<int> pick(0, 99);
+    for (size_t i = 0; i < n; ++i)
+    {
+        int r = pick(gen);
+        text[i] = r < 70 ? (char)('a' + r % 26) : r < 85 ? (char)('A' + r % 26) : r < 95 ? ' ' : (char)('0' + r % 10);
+    }
+    string out(n, '\0'), check(n, '\0');
+
+    cout << "input: " << megabytes << " MB, " << runs << " runs each" << endl;
+#if defined(__AVX2__)
+    cout << "kernels: AVX2" << endl;
+#elif defined(__SSSE3__)
+    cout << "kernels: SSSE3" << endl;
+#elif defined(__SSE2__)
+    cout << "kernels: SSE2" << endl;
+#else
+    cout << "kernels: scalar only" << endl;
+#endif
+
+    bool ok = true;
+    unsigned char table[26];
+    SubstitutionCipher keyed("ESCAPEROOM");
+    for (int i = 0; i < 26; ++i)
+    {
+        char letter = 'a' + i;
+        char mapped;
+        keyed.encodeBytes(&letter, &mapped, 1);
+        table[i] = (unsigned char)(mapped - 'a');
+    }
+
+    double scalarShift = timeRuns(n, runs, [&] { shiftLettersScalar(text.data(), &check[0], n, 3); });
+    double simdShift = timeRuns(n, runs, [&] { shiftLetters(text.data(), &out[0], n, 3); });
+    ok = ok && out == check;
+    double scalarReflect = timeRuns(n, runs, [&] { reflectLettersScalar(text.data(), &check[0], n); });
+    double simdReflect = timeRuns(n, runs, [&] { reflectLetters(text.data(), &out[0], n); });
+    ok = ok && out == check;
+    double scalarSubstitute = timeRuns(n, runs, [&] { substituteLettersScalar(text.data(), &check[0], n, table); });
+    double simdSubstitute = timeRuns(n, runs, [&] { substituteLetters(text.data(), &out[0], n, table); });
+    ok = ok && out == check;
+
+    cout << "kernel            scalar MB/s   vector MB/s" << endl;
+    cout << "shift           " << scalarShift << "   " << simdShift << endl;
+    cout << "reflect         " << scalarReflect << "   " << simdReflect << endl;
+    cout << "substitute      " << scalarSubstitute << "   " << simdSubstitute << endl;
+
+    vector<Cipher *> ciphers = {new CaesarCipher(3), new RotCipher(13), new AtbashCipher(),
+                                new VigenereCipher("LEMON"), new SubstitutionCipher("ESCAPEROOM")};
+    cout << "cipher            encode MB/s   decode MB/s" << endl;
+    for (Cipher *cipher : ciphers)
+    {
+        double encode = timeRuns(n, runs, [&] { cipher->encodeBytes(text.data(), &out[0], n); });
+        double decode = timeRuns(n, runs, [&] { cipher->decodeBytes(out.data(), &check[0], n); });
+        ok = ok && check == text;
+        cout << cipher->name() << "   " << encode << "   " << decode << endl;
+        delete cipher;
+    }
+
+    cout << (ok ? "all round trips match" : "MISMATCH between kernels") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+// Converts puzzle text from textFiles/ into the memory-mapped content store
+// read by ContentStore, then maps the result back to check it.
+//   riddles: one riddle per line -> one field. The double spaces that marked
+//            line breaks for the old fixed layout are folded to one.
+//   potions: "<scenario>!<code>[!<difficulty>]" per line -> three fields,
+//            split at the first '!'; the difficulty is empty when not given.
+//            A scenario seen before is reported and skipped.
+// Usage: contentConverter riddles|potions <input.txt> <output.bin> [copies]
+// copies > 1 repeats the input (with numbered entries) to build large packs
+// for timing the load.
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../src/contentStore.hpp"
+
+using namespace std;
+
+string foldSpaces(const string &line)
+{
+    string folded;
+    for (char c : line)
+    {
+        if (c == ' ' && (folded.empty() || folded.back() == ' '))
+        {
+            continue;
+        }
+        folded += c;
+    }
+    while (!folded.empty() && folded.back() == ' ')
+    {
+        folded.pop_back();
+    }
+    return folded;
+}
+
+bool readEntries(const string &kind, const string &path, vector<vector<string>> &entries)
+{
+    ifstream file(path);
+    if (!file.is_open())
+    {
+        cout << "Unable to open " << path << endl;
+        return false;
+    }
+    unordered_set<string> scenarios;
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line))
+    {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (kind == "riddles")
+        {
+            entries.push_back({foldSpaces(line)});
+            continue;
+        }
+        size_t delimiterPos = line.find('!');
+        if (delimiterPos == string::npos)
+        {
+            if (!line.empty())
+            {
+                cout << path << ":" << lineNumber << ": no '!' between scenario and code" << endl;
+            }
+            continue;
+        }
+        string scenario = line.substr(0, delimiterPos);
+        if (!scenarios.insert(scenario).second)
+        {
+            cout << path << ":" << lineNumber << ": scenario already listed, skipped" << endl;
+            continue;
+        }
+        string code = line.substr(delimiterPos + 1);
+        string difficulty;
+        size_t difficultyPos = code.find('!');
+        if (difficultyPos != string::npos)
+        {
+            difficulty = code.substr(difficultyPos + 1);
+            code.erase(difficultyPos);
+            if (difficulty.empty() || difficulty.find_first_not_of("0123456789") != string::npos || difficulty.size() > 3)
+            {
+                cout << path << ":" << lineNumber << ": difficulty must be a number" << endl;
+                return false;
+            }
+        }
+        entries.push_back({scenario, code, difficulty});
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    string kind = argc > 1 ? argv[1] : "";
+    if ((argc != 4 && argc != 5) || (kind != "riddles" && kind != "potions"))
+    {
+        cout << "Usage: contentConverter riddles|potions <input.txt> <output.bin> [copies]" << endl;
+        return 1;
+    }
+    int copies = argc == 5 ? max(1, atoi(argv[4])) : 1;
+    vector<vector<string>> entries;
+    if (!readEntries(kind, argv[2], entries))
+    {
+        return 1;
+    }
+    uint32_t fieldCount = kind == "riddles" ? 1 : 3;
+
+    string text;
+    vector<uint32_t> offsets;
+    for (int copy = 0; copy < copies; ++copy)
+    {
+        for (const vector<string> &entry : entries)
+        {
+            for (size_t f = 0; f < entry.size(); ++f)
+            {
+                offsets.push_back((uint32_t)text.size());
+                text += entry[f];
+                if (copy > 0 && f == 0)
+                {
+                    text += " #" + to_string(copy);
+                }
+            }
+        }
+    }
+    offsets.push_back((uint32_t)text.size());
+
+    ContentStoreHeader header;
+    memcpy(header.magic, CONTENT_STORE_MAGIC, 4);
+    header.version = CONTENT_STORE_VERSION;
+    header.entryCount = (uint32_t)(entries.size() * copies);
+    header.fieldCount = fieldCount;
+    header.indexOffset = sizeof(ContentStoreHeader);
+    header.textOffset = (uint32_t)(header.indexOffset + offsets.size() * sizeof(uint32_t));
+    header.textSize = (uint32_t)text.size();
+    {
+        ofstream out(argv[3], ios::binary);
+        out.write((const char *)&header, sizeof(header));
+        out.write((const char *)offsets.data(), offsets.size() * sizeof(uint32_t));
+        out.write(text.data(), text.size());
+        if (!out)
+        {
+            cout << "Unable to write " << argv[3] << endl;
+            return 1;
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    ContentStore store;
+    bool loaded = store.open(argv[3], fieldCount);
+    double microseconds = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    if (!loaded || store.size() != header.entryCount ||
+        (store.size() > 0 && store.field(0, fieldCount - 1) != entries[0][fieldCount - 1]))
+    {
+        cout << "Converted store does not load back" << endl;
+        return 1;
+    }
+    cout << store.size() << " " << kind << " -> " << argv[3] << " (" << header.textOffset + text.size()
+         << " bytes), loaded back in " << microseconds << " us" << endl;
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Measures hit-mask construction from RGBA32 pixels, scalar against the SSE2
+// row kernel, and checks that both produce the same bits for every width.
+// Usage: hitMaskBench [megapixels]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../src/hitMask.hpp"
+
+using namespace std;
+
+// A filled ellipse with a soft edge, like a sprite on a transparent canvas.
+vector<unsigned char> makeSprite(int width, int height, mt19937 &gen)
+{
+    vector<unsigned char> pixels((size_t)width * height * 4);
+    uniform_int_distribution<int> noise(0, 255);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            double dx = (x - width / 2.0) / (width / 2.0);
+            double dy = (y - height / 2.0) / (height / 2.0);
+            double d = dx * dx + dy * dy;
+            unsigned char *p = &pixels[((size_t)y * width + x) * 4];
+            p[0] = (unsigned char)noise(gen);
+            p[1] = (unsigned char)noise(gen);
+            p[2] = (unsigned char)noise(gen);
+            p[3] = d < 0.8 ? 255 : d < 1.0 ? (unsigned char)noise(gen) : 0;
+        }
+    }
+    return pixels;
+}
+
+int main(int argc, char *argv[])
+{
+    double megapixels = argc > 1 ? atof(argv[1]) : 256;
+    mt19937 gen(7);
+    bool ok = true;
+
+#if defined(__SSE2__)
+    cout << "kernel: SSE2" << endl;
+#else
+    cout << "kernel: scalar only" << endl;
+#endif
+
+    // Every width from 1 to 200 covers all tail lengths and word boundaries.
+    for (int width = 1; width <= 200 && ok; ++width)
+    {
+        vector<unsigned char> row = makeSprite(width, 1, gen);
+        for (int i = 0; i < width; ++i)
+        {
+            row[i * 4 + 3] = (unsigned char)(gen() & 0xff);
+        }
+        vector<uint64_t> expected((width + 63) / 64, 0), actual((width + 63) / 64, 0);
+        buildMaskRowScalar(row.data(), width, HIT_ALPHA_THRESHOLD, expected.data());
+        buildMaskRow(row.data(), width, HIT_ALPHA_THRESHOLD, actual.data());
+        ok = expected == actual;
+    }
+
+    const int side = 512;
+    vector<unsigned char> sprite = makeSprite(side, side, gen);
+    int runs = max(1, (int)(megapixels * 1000000 / (side * side)));
+    vector<uint64_t> bits((side / 64) * side);
+
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < runs; ++r)
+    {
+        fill(bits.begin(), bits.end(), 0);
+        for (int y = 0; y < side; ++y)
+        {
+            buildMaskRowScalar(&sprite[(size_t)y * side * 4], side, HIT_ALPHA_THRESHOLD, &bits[y * (side / 64)]);
+        }
+    }
+    double scalarSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    vector<uint64_t> scalarBits = bits;
+
+    HitMask mask;
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < runs; ++r)
+    {
+        mask.buildFromRGBA(sprite.data(), side, side, side * 4);
+    }
+    double vectorSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    ok = ok && mask.getBits() == scalarBits;
+
+    double pixels = (double)runs * side * side / 1000000;
+    cout << "scalar: " << pixels / scalarSeconds << " Mpixel/s" << endl;
+    cout << "HitMask: " << pixels / vectorSeconds << " Mpixel/s" << endl;
+    cout << "mask size: " << mask.getBits().size() * sizeof(uint64_t) << " bytes for " << side << "x" << side
+         << " (" << side * side * 4 << " bytes of RGBA)" << endl;
+    if (!ok)
+    {
+        cout << "SSE2 and scalar masks differ" << endl;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,333 @@
+// Compiles hidden-object levels from their text form into the binary pack
+// read by LevelPack, then maps the result back to check it.
+// Usage: levelCompiler <levels.txt> <levels.bin>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../src/levelPack.hpp"
+
+using namespace std;
+
+const size_t MAX_LEVEL_OBJECTS = 65535;
+
+struct LevelSource
+{
+    string title;
+    int areaX = 0, areaY = 0, areaW = 600, areaH = 600;
+    int spacing = 10;
+    vector<string> keys;
+    vector<LevelObjectRecord> objects;
+    vector<string> images, names;
+    vector<uint16_t> order;
+    int orderLine = 0;
+};
+
+class Compiler
+{
+public:
+    vector<LevelSource> levels;
+
+    bool parse(const string &path)
+    {
+        ifstream file(path);
+        if (!file.is_open())
+        {
+            cout << "Unable to open " << path << endl;
+            return false;
+        }
+        string line;
+        int lineNumber = 0;
+        bool ok = true;
+        while (getline(file, line))
+        {
+            ++lineNumber;
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            istringstream in(line);
+            string command;
+            if (!(in >> command) || command[0] == '#')
+            {
+                continue;
+            }
+            if (!parseLine(command, in, lineNumber))
+            {
+                ok = false;
+            }
+        }
+        return ok && finish();
+    }
+
+private:
+    bool fail(int lineNumber, const string &message)
+    {
+        cout << "line " << lineNumber << ": " << message << endl;
+        return false;
+    }
+
+    static string rest(istringstream &in)
+    {
+        string text;
+        getline(in >> ws, text);
+        return text;
+    }
+
+    bool parseLine(const string &command, istringstream &in, int lineNumber)
+    {
+        if (command == "level")
+        {
+            levels.emplace_back();
+            levels.back().title = rest(in);
+            return true;
+        }
+        if (levels.empty())
+        {
+            return fail(lineNumber, "'" + command + "' before the first 'level'");
+        }
+        LevelSource &level = levels.back();
+        if (command == "area")
+        {
+            if (!(in >> level.areaX >> level.areaY >> level.areaW >> level.areaH) || level.areaW <= 0 || level.areaH <= 0)
+            {
+                return fail(lineNumber, "expected 'area <x> <y> <w> <h>'");
+            }
+            const SDL_Rect &scene = LEVEL_SCENE_AREA;
+            if (level.areaX < scene.x || level.areaY < scene.y || level.areaX + level.areaW > scene.x + scene.w ||
+                level.areaY + level.areaH > scene.y + scene.h)
+            {
+                return fail(lineNumber, "area must lie inside the scene (" + to_string(scene.x) + " " + to_string(scene.y) + " " +
+                                            to_string(scene.w) + " " + to_string(scene.h) + ")");
+            }
+            return true;
+        }
+        if (command == "spacing")
+        {
+            if (!(in >> level.spacing) || level.spacing < 0)
+            {
+                return fail(lineNumber, "expected 'spacing <pixels>'");
+            }
+            return true;
+        }
+        if (command == "object")
+        {
+            return parseObject(level, in, lineNumber);
+        }
+        if (command == "order")
+        {
+            level.orderLine = lineNumber;
+            string key;
+            while (in >> key)
+            {
+                size_t i = 0;
+                while (i < level.keys.size() && level.keys[i] != key)
+                {
+                    ++i;
+                }
+                if (i == level.keys.size())
+                {
+                    return fail(lineNumber, "unknown object '" + key + "'");
+                }
+                for (uint16_t listed : level.order)
+                {
+                    if (listed == i)
+                    {
+                        return fail(lineNumber, "object '" + key + "' is listed twice");
+                    }
+                }
+                level.order.push_back((uint16_t)i);
+            }
+            return true;
+        }
+        return fail(lineNumber, "unknown command '" + command + "'");
+    }
+
+    bool parseObject(LevelSource &level, istringstream &in, int lineNumber)
+    {
+        string key, image, placement;
+        int width, height;
+        if (!(in >> key >> image >> width >> height >> placement) || width <= 0 || height <= 0)
+        {
+            return fail(lineNumber, "expected 'object <key> <image> <w> <h> random|<x> <y> <name>'");
+        }
+        LevelObjectRecord record = {};
+        record.width = (uint16_t)width;
+        record.height = (uint16_t)height;
+        if (placement == "random")
+        {
+            record.placement = PLACE_RANDOM;
+        }
+        else
+        {
+            int x, y;
+            istringstream position(placement);
+            if (!(position >> x) || !(in >> y))
+            {
+                return fail(lineNumber, "expected 'random' or '<x> <y>'");
+            }
+            record.placement = PLACE_FIXED;
+            record.x = (int16_t)x;
+            record.y = (int16_t)y;
+        }
+        for (const string &existing : level.keys)
+        {
+            if (existing == key)
+            {
+                return fail(lineNumber, "duplicate object '" + key + "'");
+            }
+        }
+        if (level.objects.size() >= MAX_LEVEL_OBJECTS)
+        {
+            return fail(lineNumber, "too many objects in one level");
+        }
+        string name = rest(in);
+        level.keys.push_back(key);
+        level.objects.push_back(record);
+        level.images.push_back(image);
+        level.names.push_back(name.empty() ? key : name);
+        return true;
+    }
+
+    bool finish()
+    {
+        bool ok = !levels.empty();
+        if (!ok)
+        {
+            cout << "no levels found" << endl;
+        }
+        for (LevelSource &level : levels)
+        {
+            if (level.objects.empty())
+            {
+                cout << "level '" << level.title << "' has no objects" << endl;
+                ok = false;
+            }
+            // Without an order line the objects are found in listed order.
+            // With one, only the listed objects have to be found; the rest
+            // are decoys.
+            if (level.order.empty())
+            {
+                for (size_t i = 0; i < level.objects.size(); ++i)
+                {
+                    level.order.push_back((uint16_t)i);
+                }
+            }
+            for (size_t i = 0; i < level.objects.size(); ++i)
+            {
+                const LevelObjectRecord &object = level.objects[i];
+                if (object.placement == PLACE_FIXED &&
+                    (object.x < level.areaX || object.y < level.areaY || object.x + object.width > level.areaX + level.areaW ||
+                     object.y + object.height > level.areaY + level.areaH))
+                {
+                    cout << "level '" << level.title << "': object '" << level.keys[i] << "' lies outside the area" << endl;
+                    ok = false;
+                }
+            }
+        }
+        return ok;
+    }
+};
+
+// Each distinct string is stored once in the blob.
+uint32_t intern(string &text, unordered_map<string, uint32_t> &offsets, const string &value)
+{
+    auto it = offsets.find(value);
+    if (it != offsets.end())
+    {
+        return it->second;
+    }
+    uint32_t offset = (uint32_t)text.length();
+    text += value;
+    offsets[value] = offset;
+    return offset;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        cout << "Usage: levelCompiler <levels.txt> <levels.bin>" << endl;
+        return 1;
+    }
+    Compiler compiler;
+    if (!compiler.parse(argv[1]))
+    {
+        return 1;
+    }
+
+    vector<LevelRecord> levels;
+    vector<LevelObjectRecord> objects;
+    vector<uint16_t> order;
+    string text;
+    unordered_map<string, uint32_t> offsets;
+    for (const LevelSource &source : compiler.levels)
+    {
+        LevelRecord record = {};
+        record.titleOffset = intern(text, offsets, source.title);
+        record.titleLength = (uint16_t)source.title.length();
+        record.spacing = (uint16_t)source.spacing;
+        record.areaX = (int16_t)source.areaX;
+        record.areaY = (int16_t)source.areaY;
+        record.areaW = (uint16_t)source.areaW;
+        record.areaH = (uint16_t)source.areaH;
+        record.firstObject = (uint32_t)objects.size();
+        record.objectCount = (uint16_t)source.objects.size();
+        record.firstOrder = (uint32_t)order.size();
+        record.orderCount = (uint16_t)source.order.size();
+        for (size_t i = 0; i < source.objects.size(); ++i)
+        {
+            LevelObjectRecord object = source.objects[i];
+            object.imageOffset = intern(text, offsets, source.images[i]);
+            object.imageLength = (uint16_t)source.images[i].length();
+            object.nameOffset = intern(text, offsets, source.names[i]);
+            object.nameLength = (uint16_t)source.names[i].length();
+            objects.push_back(object);
+        }
+        order.insert(order.end(), source.order.begin(), source.order.end());
+        levels.push_back(record);
+    }
+
+    LevelPackHeader header;
+    memcpy(header.magic, LEVEL_PACK_MAGIC, 4);
+    header.version = LEVEL_PACK_VERSION;
+    header.levelCount = (uint32_t)levels.size();
+    header.levelOffset = sizeof(LevelPackHeader);
+    header.objectCount = (uint32_t)objects.size();
+    header.objectOffset = (uint32_t)(header.levelOffset + levels.size() * sizeof(LevelRecord));
+    header.orderCount = (uint32_t)order.size();
+    header.orderOffset = (uint32_t)(header.objectOffset + objects.size() * sizeof(LevelObjectRecord));
+    header.textOffset = (uint32_t)(header.orderOffset + order.size() * sizeof(uint16_t));
+    header.textSize = (uint32_t)text.length();
+
+    {
+        ofstream out(argv[2], ios::binary);
+        out.write((const char *)&header, sizeof(header));
+        out.write((const char *)levels.data(), levels.size() * sizeof(LevelRecord));
+        out.write((const char *)objects.data(), objects.size() * sizeof(LevelObjectRecord));
+        out.write((const char *)order.data(), order.size() * sizeof(uint16_t));
+        out.write(text.data(), text.length());
+        if (!out)
+        {
+            cout << "Unable to write " << argv[2] << endl;
+            return 1;
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    LevelPack pack;
+    Level level;
+    bool loaded = pack.open(argv[2]) && pack.getLevel(0, level);
+    double microseconds = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    if (!loaded)
+    {
+        cout << "Compiled pack does not load back" << endl;
+        return 1;
+    }
+    cout << levels.size() << " levels, " << objects.size() << " objects -> " << argv[2] << " ("
+         << header.textOffset + text.length() << " bytes), loaded back in " << microseconds << " us" << endl;
+    return 0;
+}
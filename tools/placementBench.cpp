@@ -0,0 +1,140 @@
+// Times PoissonPlacer against the old dart-throwing placement (random spot,
+// linear overlap scan over every earlier object) and checks that no placed
+// object overlaps another one or a forbidden region.
+// Usage: placementBench [maxObjects]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../src/placement.hpp"
+
+using namespace std;
+
+const int DART_ATTEMPTS = 1000;
+
+bool overlaps(const SDL_Rect &a, const SDL_Rect &b)
+{
+    return a.x < b.x + b.w && a.x + a.w > b.x && a.y < b.y + b.h && a.y + a.h > b.y;
+}
+
+int placeWithDarts(const SDL_Rect &area, const vector<SDL_Rect> &forbidden, vector<Placement> &items, mt19937 &gen)
+{
+    int placedCount = 0;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        Placement &item = items[i];
+        uniform_int_distribution<int> pickX(area.x, area.x + area.w - item.width);
+        uniform_int_distribution<int> pickY(area.y, area.y + area.h - item.height);
+        item.placed = false;
+        for (int attempt = 0; attempt < DART_ATTEMPTS && !item.placed; ++attempt)
+        {
+            SDL_Rect rect = {pickX(gen), pickY(gen), item.width, item.height};
+            bool clear = true;
+            for (size_t j = 0; j < forbidden.size() && clear; ++j)
+            {
+                clear = !overlaps(rect, forbidden[j]);
+            }
+            for (size_t j = 0; j < i && clear; ++j)
+            {
+                clear = !items[j].placed || !overlaps(rect, {items[j].x, items[j].y, items[j].width, items[j].height});
+            }
+            if (clear)
+            {
+                item.x = rect.x;
+                item.y = rect.y;
+                item.placed = true;
+                ++placedCount;
+            }
+        }
+    }
+    return placedCount;
+}
+
+// Grid-accelerated check so that verifying 10k objects stays cheap.
+bool verify(const SDL_Rect &area, const vector<SDL_Rect> &forbidden, const vector<Placement> &items)
+{
+    SpatialGrid grid(area.w, area.h, 64);
+    vector<int> ids;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const Placement &item = items[i];
+        if (!item.placed)
+        {
+            continue;
+        }
+        SDL_Rect rect = {item.x, item.y, item.width, item.height};
+        if (rect.x < area.x || rect.y < area.y || rect.x + rect.w > area.x + area.w || rect.y + rect.h > area.y + area.h)
+        {
+            return false;
+        }
+        for (const SDL_Rect &blocked : forbidden)
+        {
+            if (overlaps(rect, blocked))
+            {
+                return false;
+            }
+        }
+        SDL_Rect local = {rect.x - area.x, rect.y - area.y, rect.w, rect.h};
+        grid.queryRect(local, ids);
+        for (int id : ids)
+        {
+            if (overlaps(rect, {items[id].x, items[id].y, items[id].width, items[id].height}))
+            {
+                return false;
+            }
+        }
+        grid.insert((int)i, local);
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    int maxObjects = argc > 1 ? atoi(argv[1]) : 10000;
+    mt19937 gen(1234);
+    uniform_int_distribution<int> pickSide(20, 60);
+    bool ok = true;
+
+    cout << "objects   area        poisson ms  placed  spacing   darts ms  placed" << endl;
+    const int sizes[] = {5, 50, 100, 500, 1000, 2500, 5000, 10000};
+    for (int n : sizes)
+    {
+        if (n > maxObjects)
+        {
+            break;
+        }
+        // The room grows with n so the objects cover about a third of it,
+        // which is as crowded as a hidden-object screen gets.
+        int side = max(600, (int)sqrt(n * 40.0 * 40.0 * 3));
+        SDL_Rect area = {0, 0, side, side};
+        vector<SDL_Rect> forbidden = {{side / 4, side / 4, side / 8, side / 8}, {side / 2, side / 2, side / 5, side / 10}};
+
+        vector<Placement> items(n);
+        for (Placement &item : items)
+        {
+            item.width = pickSide(gen);
+            item.height = pickSide(gen);
+        }
+        vector<Placement> darts = items;
+
+        PoissonPlacer placer(area, 2);
+        for (const SDL_Rect &rect : forbidden)
+        {
+            placer.addForbidden(rect);
+        }
+        auto start = chrono::steady_clock::now();
+        int placed = placer.place(items, gen);
+        double poissonMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        int dartPlaced = placeWithDarts(area, forbidden, darts, gen);
+        double dartMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        bool valid = verify(area, forbidden, items) && verify(area, forbidden, darts);
+        ok = ok && valid;
+        cout << n << "\t  " << side << "x" << side << "\t" << poissonMs << "\t" << placed << "\t" << placer.getSpacing()
+             << "\t" << dartMs << "\t" << dartPlaced << (valid ? "" : "  OVERLAP") << endl;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+// Times PotionCatalog against the old potion table (unordered_map from
+// scenario to code, picked by walking rand() % size steps from begin()) on
+// generated catalogs, and checks that uniform picks are spread evenly, that
+// difficulty weights come out in proportion and that no pick repeats within
+// the recent window.
+// Usage: potionBench [maxPotions]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../src/potionCatalog.hpp"
+
+using namespace std;
+
+const int PICKS = 200000;
+const int LOOKUPS = 200000;
+const size_t RECENT_WINDOW = 3;
+
+double elapsedNs(chrono::steady_clock::time_point start, int count)
+{
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / count;
+}
+
+// Every potion is drawn about PICKS / n times; the worst one should be
+// within a few standard deviations of that.
+bool checkUniform(PotionCatalog &catalog, mt19937 &gen)
+{
+    size_t n = catalog.size();
+    vector<int> counts(n, 0);
+    int draws = (int)(n * 200);
+    for (int i = 0; i < draws; ++i)
+    {
+        counts[catalog.pick(gen)]++;
+    }
+    int lowest = draws, highest = 0;
+    for (int count : counts)
+    {
+        lowest = min(lowest, count);
+        highest = max(highest, count);
+    }
+    return lowest > 200 - 6 * sqrt(200.0) && highest < 200 + 6 * sqrt(200.0);
+}
+
+// Difficulty 2 against the target 2 weighs 1, 1 and 3 weigh 1/2, 4 weighs 1/3.
+bool checkWeights(PotionCatalog &catalog, mt19937 &gen)
+{
+    vector<double> expected(5, 0.0), seen(5, 0.0);
+    double total = 0;
+    for (size_t i = 0; i < catalog.size(); ++i)
+    {
+        int difficulty = catalog.entry(i).difficulty;
+        double weight = 1.0 / (1 + abs(difficulty - DEFAULT_POTION_DIFFICULTY));
+        expected[difficulty] += weight;
+        total += weight;
+    }
+    for (int i = 0; i < PICKS; ++i)
+    {
+        seen[catalog.entry(catalog.pick(gen)).difficulty] += 1;
+    }
+    bool ok = true;
+    for (int d = 0; d < 5; ++d)
+    {
+        ok = ok && abs(seen[d] / PICKS - expected[d] / total) < 0.01;
+    }
+    return ok;
+}
+
+bool checkRecent(PotionCatalog &catalog, mt19937 &gen)
+{
+    vector<size_t> history;
+    for (int i = 0; i < PICKS; ++i)
+    {
+        size_t id = catalog.pick(gen);
+        for (size_t back = 1; back <= RECENT_WINDOW && back <= history.size(); ++back)
+        {
+            if (history[history.size() - back] == id)
+            {
+                return false;
+            }
+        }
+        history.push_back(id);
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t maxPotions = argc > 1 ? (size_t)atol(argv[1]) : 100000;
+    mt19937 gen(1234);
+    uniform_int_distribution<int> pickDifficulty(0, 4);
+    bool ok = true;
+
+    cout << "potions  build ms  pick ns  find ns   map pick ns  map find ns  checks" << endl;
+    const size_t sizes[] = {6, 100, 1000, 10000, 100000};
+    for (size_t n : sizes)
+    {
+        if (n > maxPotions)
+        {
+            break;
+        }
+        vector<string> scenarios(n), codes(n);
+        vector<PotionEntry> entries(n);
+        unordered_map<string, string> table;
+        for (size_t i = 0; i < n; ++i)
+        {
+            scenarios[i] = "Brew the potion of scenario number " + to_string(i) + " before the candle burns out";
+            codes[i] = "P" + to_string(i * 7919 % 100000);
+            table[scenarios[i]] = codes[i];
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            entries[i] = {scenarios[i], codes[i], pickDifficulty(gen)};
+        }
+
+        PotionCatalog catalog;
+        auto start = chrono::steady_clock::now();
+        catalog.build(entries);
+        double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        bool uniform = checkUniform(catalog, gen);
+
+        size_t sink = 0;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < PICKS; ++i)
+        {
+            sink += catalog.pick(gen);
+        }
+        double pickNs = elapsedNs(start, PICKS);
+
+        uniform_int_distribution<size_t> pickId(0, n - 1);
+        vector<size_t> queries(LOOKUPS);
+        for (size_t &query : queries)
+        {
+            query = pickId(gen);
+        }
+        bool found = true;
+        start = chrono::steady_clock::now();
+        for (size_t query : queries)
+        {
+            found = found && catalog.find(scenarios[query]) == (long)query;
+        }
+        double findNs = elapsedNs(start, LOOKUPS);
+        found = found && catalog.find("no such potion") == -1;
+
+        // The old pick walked the map one node at a time, so it is timed on
+        // fewer draws.
+        int mapPicks = max(100, (int)(PICKS / max<size_t>(1, n / 100)));
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < mapPicks; ++i)
+        {
+            auto it = table.begin();
+            advance(it, rand() % table.size());
+            sink += it->second.size();
+        }
+        double mapPickNs = elapsedNs(start, mapPicks);
+
+        start = chrono::steady_clock::now();
+        for (size_t query : queries)
+        {
+            sink += table.find(scenarios[query])->second.size();
+        }
+        double mapFindNs = elapsedNs(start, LOOKUPS);
+
+        catalog.setRecentWindow(RECENT_WINDOW);
+        catalog.weightByDifficulty(DEFAULT_POTION_DIFFICULTY);
+        bool recent = checkRecent(catalog, gen);
+        bool weighted = n < 1000 || checkWeights(catalog, gen);
+
+        bool valid = uniform && found && recent && weighted;
+        ok = ok && valid;
+        cout << n << "\t " << buildMs << "\t   " << pickNs << "\t    " << findNs << "\t     " << mapPickNs << "\t  "
+             << mapFindNs << "\t" << (valid ? "ok" : "FAILED") << (sink == 42 ? " " : "") << endl;
+        if (!valid)
+        {
+            cout << "  uniform " << uniform << " find " << found << " recent " << recent << " weighted " << weighted << endl;
+        }
+    }
+    return ok ? 0 : 1;
+}
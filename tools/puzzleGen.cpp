@@ -0,0 +1,357 @@
+// Generates the decoding-door puzzle pack read by PuzzlePack.
+// Usage: puzzleGen <dictionary.txt> <output.bin> [--count N] [--threads T]
+//                  [--min-shift A] [--max-shift B] [--atbash] [--seed S]
+//
+// Every puzzle is checked for ambiguity: no other dictionary word may encode
+// to the same ciphertext under any allowed key (Caesar shifts 1-25, plus
+// Atbash when --atbash is given), so the answer the player types is unique.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "../src/cipher.hpp"
+#include "../src/puzzlePack.hpp"
+
+using namespace std;
+
+const size_t MAX_WORD_LENGTH = 20;
+const int MAX_ATTEMPTS_PER_PUZZLE = 1000;
+// Puzzles are generated in fixed blocks, each with its own seed, and merged
+// in block order, so the pack depends on --seed alone and not on --threads.
+const size_t PUZZLES_PER_BLOCK = 4096;
+
+struct Options
+{
+    string dictionaryPath, outputPath;
+    size_t count = 1000000;
+    unsigned threads = 0;
+    int minShift = 1, maxShift = 25;
+    bool atbash = false;
+    uint32_t seed = 1;
+};
+
+// Two words are Caesar shifts of each other exactly when they have the same
+// letter differences relative to their first letter.
+string shiftClass(const string &word)
+{
+    string key = word;
+    int first = -1;
+    for (char &c : key)
+    {
+        if (c >= 'a' && c <= 'z')
+        {
+            if (first < 0)
+            {
+                first = c - 'a';
+            }
+            c = (char)('a' + (c - 'a' - first + 26) % 26);
+        }
+    }
+    return key;
+}
+
+class Dictionary
+{
+public:
+    vector<string> words;
+    unordered_set<string> lookup;
+    unordered_map<string, int> classSize;
+
+    bool load(const string &path)
+    {
+        ifstream file(path);
+        if (!file.is_open())
+        {
+            cout << "Unable to open dictionary " << path << endl;
+            return false;
+        }
+        string line;
+        while (getline(file, line))
+        {
+            string word;
+            for (char c : line)
+            {
+                if (c >= 'A' && c <= 'Z')
+                {
+                    c = (char)(c - 'A' + 'a');
+                }
+                if ((c >= 'a' && c <= 'z') || (c == ' ' && !word.empty() && word.back() != ' '))
+                {
+                    word += c;
+                }
+            }
+            while (!word.empty() && word.back() == ' ')
+            {
+                word.pop_back();
+            }
+            if (!word.empty() && word.length() <= MAX_WORD_LENGTH && lookup.insert(word).second)
+            {
+                words.push_back(word);
+                classSize[shiftClass(word)]++;
+            }
+        }
+        return !words.empty();
+    }
+
+    bool isAmbiguous(const string &plainText, const string &cipherText, bool atbashAllowed) const
+    {
+        auto it = classSize.find(shiftClass(cipherText));
+        int others = (it == classSize.end()) ? 0 : it->second;
+        if (shiftClass(plainText) == shiftClass(cipherText))
+        {
+            --others;
+        }
+        // A dictionary word equal to the ciphertext would need shift 0.
+        if (lookup.count(cipherText) != 0)
+        {
+            --others;
+        }
+        if (others > 0)
+        {
+            return true;
+        }
+        if (atbashAllowed)
+        {
+            string reflected = AtbashCipher().decode(cipherText);
+            if (reflected != plainText && lookup.count(reflected) != 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+int difficultyOf(const string &word, int cipher, int key)
+{
+    int letters = (int)count_if(word.begin(), word.end(), [](char c) { return c != ' '; });
+    int distance = min(key, 26 - key);
+    int score = (letters >= 6) + (letters >= 9) + (cipher == PUZZLE_CAESAR && distance >= 4) +
+                (cipher == PUZZLE_CAESAR && distance >= 9) + (cipher == PUZZLE_ATBASH) * 2;
+    return 1 + min(score, 4);
+}
+
+struct WorkerOutput
+{
+    vector<PuzzleRecord> records;
+    string cipherText;
+    size_t rejected = 0;
+    bool failed = false;
+};
+
+void generateRange(const Dictionary &dictionary, const vector<uint32_t> &wordOffsets, const Options &options,
+                   size_t count, uint32_t seed, WorkerOutput &output)
+{
+    mt19937 gen(seed);
+    uniform_int_distribution<size_t> pickWord(0, dictionary.words.size() - 1);
+    uniform_int_distribution<int> pickShift(options.minShift, options.maxShift);
+    uniform_int_distribution<int> pickCipher(0, options.atbash ? 4 : 0);
+    output.records.reserve(count);
+
+    string encoded;
+    for (size_t i = 0; i < count; ++i)
+    {
+        int attempts = 0;
+        while (true)
+        {
+            if (++attempts > MAX_ATTEMPTS_PER_PUZZLE)
+            {
+                output.failed = true;
+                return;
+            }
+            size_t wordIndex = pickWord(gen);
+            const string &word = dictionary.words[wordIndex];
+            // One puzzle in five is Atbash when it is enabled.
+            int cipher = (pickCipher(gen) == 4) ? PUZZLE_ATBASH : PUZZLE_CAESAR;
+            int key = (cipher == PUZZLE_CAESAR) ? pickShift(gen) : 0;
+
+            encoded.resize(word.length());
+            if (cipher == PUZZLE_CAESAR)
+            {
+                shiftLetters(word.data(), &encoded[0], word.length(), key);
+            }
+            else
+            {
+                reflectLetters(word.data(), &encoded[0], word.length());
+            }
+
+            if (dictionary.isAmbiguous(word, encoded, options.atbash))
+            {
+                output.rejected++;
+                continue;
+            }
+
+            PuzzleRecord record;
+            record.plainOffset = wordOffsets[wordIndex];
+            record.cipherOffset = (uint32_t)output.cipherText.length();
+            record.length = (uint8_t)word.length();
+            record.cipher = (uint8_t)cipher;
+            record.key = (uint8_t)key;
+            record.difficulty = (uint8_t)difficultyOf(word, cipher, key);
+            output.records.push_back(record);
+            output.cipherText += encoded;
+            break;
+        }
+    }
+}
+
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    if (argc < 3)
+    {
+        return false;
+    }
+    options.dictionaryPath = argv[1];
+    options.outputPath = argv[2];
+    for (int i = 3; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--atbash")
+        {
+            options.atbash = true;
+        }
+        else if (arg == "--count" && hasValue)
+        {
+            options.count = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            options.threads = (unsigned)strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--min-shift" && hasValue)
+        {
+            options.minShift = atoi(argv[++i]);
+        }
+        else if (arg == "--max-shift" && hasValue)
+        {
+            options.maxShift = atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue)
+        {
+            options.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.minShift >= 1 && options.maxShift <= 25 && options.minShift <= options.maxShift;
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        cout << "Usage: puzzleGen <dictionary.txt> <output.bin> [--count N] [--threads T]" << endl
+             << "                 [--min-shift A] [--max-shift B] [--atbash] [--seed S]" << endl;
+        return 1;
+    }
+
+    Dictionary dictionary;
+    if (!dictionary.load(options.dictionaryPath))
+    {
+        cout << "No usable words in " << options.dictionaryPath << endl;
+        return 1;
+    }
+
+    // Each dictionary word is stored once at the start of the text blob and
+    // every puzzle's plaintext points back into it.
+    string plainText;
+    vector<uint32_t> wordOffsets;
+    for (const string &word : dictionary.words)
+    {
+        wordOffsets.push_back((uint32_t)plainText.length());
+        plainText += word;
+    }
+
+    size_t blocks = max<size_t>(1, (options.count + PUZZLES_PER_BLOCK - 1) / PUZZLES_PER_BLOCK);
+    unsigned threads = options.threads ? options.threads : max(1u, thread::hardware_concurrency());
+    threads = (unsigned)min<size_t>(threads, blocks);
+    vector<WorkerOutput> outputs(blocks);
+    vector<thread> workers;
+
+    auto start = chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]() {
+            for (size_t b = t; b < blocks; b += threads)
+            {
+                size_t begin = b * PUZZLES_PER_BLOCK;
+                size_t end = min(options.count, begin + PUZZLES_PER_BLOCK);
+                generateRange(dictionary, wordOffsets, options, end - begin, options.seed * 7919u + (uint32_t)b, outputs[b]);
+            }
+        });
+    }
+    for (thread &worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    size_t rejected = 0;
+    for (const WorkerOutput &output : outputs)
+    {
+        rejected += output.rejected;
+        if (output.failed)
+        {
+            cout << "Too many ambiguous words: could not fill the pack. Use a larger dictionary." << endl;
+            return 1;
+        }
+    }
+
+    // Stitch the per-block cipher texts after the plaintext words.
+    string text = plainText;
+    vector<PuzzleRecord> records;
+    records.reserve(options.count);
+    for (const WorkerOutput &output : outputs)
+    {
+        uint32_t base = (uint32_t)text.length();
+        for (PuzzleRecord record : output.records)
+        {
+            record.cipherOffset += base;
+            records.push_back(record);
+        }
+        text += output.cipherText;
+    }
+    if (text.length() > UINT32_MAX)
+    {
+        cout << "Pack text exceeds 4 GB; generate fewer puzzles." << endl;
+        return 1;
+    }
+
+    PuzzlePackHeader header;
+    memcpy(header.magic, PUZZLE_PACK_MAGIC, 4);
+    header.version = PUZZLE_PACK_VERSION;
+    header.count = (uint32_t)records.size();
+    header.recordOffset = sizeof(PuzzlePackHeader);
+    header.textOffset = (uint32_t)(header.recordOffset + records.size() * sizeof(PuzzleRecord));
+    header.textSize = (uint32_t)text.length();
+
+    ofstream out(options.outputPath, ios::binary);
+    out.write((const char *)&header, sizeof(header));
+    out.write((const char *)records.data(), records.size() * sizeof(PuzzleRecord));
+    out.write(text.data(), text.length());
+    if (!out)
+    {
+        cout << "Unable to write " << options.outputPath << endl;
+        return 1;
+    }
+
+    cout << dictionary.words.size() << " words, " << records.size() << " puzzles, " << rejected
+         << " ambiguous candidates rejected" << endl;
+    cout << threads << " threads, " << seconds << " s, " << (seconds > 0 ? records.size() / seconds : 0)
+         << " puzzles/s" << endl;
+    cout << "wrote " << options.outputPath << " (" << sizeof(header) + records.size() * sizeof(PuzzleRecord) + text.length()
+         << " bytes)" << endl;
+    return 0;
+}
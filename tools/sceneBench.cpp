@@ -0,0 +1,153 @@
+// Measures click resolution and visible-set queries of SceneIndex against a
+// walk over every object, from 5 to 10,000 objects. The scene grows with the
+// object count while the camera stays one 600x600 screen, as when scrolling
+// around a large room.
+// Usage: sceneBench [maxObjects]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../src/placement.hpp"
+#include "../src/sceneIndex.hpp"
+
+using namespace std;
+
+const int QUERIES = 20000;
+
+int linearTopmost(const vector<SDL_Rect> &rects, const vector<bool> &hidden, int x, int y)
+{
+    int topmost = -1;
+    for (int i = 0; i < (int)rects.size(); ++i)
+    {
+        const SDL_Rect &rect = rects[i];
+        if (!hidden[i] && x >= rect.x && x <= rect.x + rect.w && y >= rect.y && y <= rect.y + rect.h)
+        {
+            topmost = i;
+        }
+    }
+    return topmost;
+}
+
+void linearVisible(const vector<SDL_Rect> &rects, const vector<bool> &hidden, const SDL_Rect &camera, vector<int> &indices)
+{
+    indices.clear();
+    for (int i = 0; i < (int)rects.size(); ++i)
+    {
+        const SDL_Rect &rect = rects[i];
+        if (!hidden[i] && rect.x < camera.x + camera.w && rect.x + rect.w > camera.x && rect.y < camera.y + camera.h &&
+            rect.y + rect.h > camera.y)
+        {
+            indices.push_back(i);
+        }
+    }
+}
+
+double nanosecondsPer(chrono::steady_clock::time_point start, int count)
+{
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / count;
+}
+
+int main(int argc, char *argv[])
+{
+    int maxObjects = argc > 1 ? atoi(argv[1]) : 10000;
+    mt19937 gen(99);
+    uniform_int_distribution<int> pickSide(20, 50);
+    bool ok = true;
+
+    cout << "objects   click ns (index / list)   visible ns (index / list)   in last camera" << endl;
+    const int sizes[] = {5, 50, 100, 500, 1000, 2500, 5000, 10000};
+    for (int n : sizes)
+    {
+        if (n > maxObjects)
+        {
+            break;
+        }
+        int side = max(600, (int)sqrt(n * 35.0 * 35.0 * 3));
+        SDL_Rect area = {0, 0, side, side};
+        vector<Placement> items(n);
+        for (Placement &item : items)
+        {
+            item.width = pickSide(gen);
+            item.height = pickSide(gen);
+        }
+        PoissonPlacer(area, 2).place(items, gen);
+
+        SceneIndex index(side, side);
+        vector<SDL_Rect> rects;
+        vector<bool> hidden;
+        for (const Placement &item : items)
+        {
+            SDL_Rect rect = {item.x, item.y, item.width, item.height};
+            index.add(rect);
+            rects.push_back(rect);
+            hidden.push_back(!item.placed);
+            if (!item.placed)
+            {
+                index.hide((int)rects.size() - 1);
+            }
+        }
+        // Hide a tenth of the objects, as if they had been found.
+        for (int i = 0; i < n; i += 10)
+        {
+            index.hide(i);
+            hidden[i] = true;
+        }
+
+        uniform_int_distribution<int> pickPoint(0, side);
+        uniform_int_distribution<int> pickCamera(0, side - 600);
+        vector<SDL_Point> points(QUERIES);
+        vector<SDL_Rect> cameras(QUERIES / 10);
+        for (SDL_Point &point : points)
+        {
+            point = {pickPoint(gen), pickPoint(gen)};
+        }
+        for (SDL_Rect &camera : cameras)
+        {
+            camera = {pickCamera(gen), pickCamera(gen), 600, 600};
+        }
+
+        long checksum = 0;
+        auto start = chrono::steady_clock::now();
+        for (const SDL_Point &point : points)
+        {
+            checksum += index.topmostAt(point.x, point.y);
+        }
+        double indexClick = nanosecondsPer(start, QUERIES);
+        start = chrono::steady_clock::now();
+        for (const SDL_Point &point : points)
+        {
+            checksum -= linearTopmost(rects, hidden, point.x, point.y);
+        }
+        double listClick = nanosecondsPer(start, QUERIES);
+        ok = ok && checksum == 0;
+
+        vector<int> fromIndex, fromList;
+        size_t onScreen = 0;
+        start = chrono::steady_clock::now();
+        for (const SDL_Rect &camera : cameras)
+        {
+            index.visibleIn(camera, fromIndex);
+            onScreen += fromIndex.size();
+        }
+        double indexVisible = nanosecondsPer(start, (int)cameras.size());
+        start = chrono::steady_clock::now();
+        for (const SDL_Rect &camera : cameras)
+        {
+            linearVisible(rects, hidden, camera, fromList);
+            onScreen -= fromList.size();
+        }
+        double listVisible = nanosecondsPer(start, (int)cameras.size());
+        index.visibleIn(cameras[0], fromIndex);
+        linearVisible(rects, hidden, cameras[0], fromList);
+        ok = ok && onScreen == 0 && fromIndex == fromList;
+
+        cout << n << "\t  " << indexClick << " / " << listClick << "\t\t" << indexVisible << " / " << listVisible << "\t\t"
+             << fromIndex.size() << endl;
+    }
+    if (!ok)
+    {
+        cout << "index and list disagree" << endl;
+    }
+    return ok ? 0 : 1;
+}